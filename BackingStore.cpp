@@ -78,3 +78,29 @@ void BackingStore::displayContents() const {
             << ", Instructions: " << process->getTotalInstructions() << std::endl;
     }
 }
+
+int BackingStore::allocateSlot() {
+    if (!freeSlots.empty()) {
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    slotContents.push_back({ -1, -1 });
+    return static_cast<int>(slotContents.size()) - 1;
+}
+
+void BackingStore::writePage(int slot, int pid, int page) {
+    if (outputFile.is_open()) {
+        outputFile << "page " << slot << " " << pid << " " << page << "\n";
+    }
+    slotContents[slot] = { pid, page };
+}
+
+bool BackingStore::readPage(int slot) const {
+    return slot < static_cast<int>(slotContents.size()) && slotContents[slot].first != -1;
+}
+
+void BackingStore::freeSlot(int slot) {
+    slotContents[slot] = { -1, -1 };
+    freeSlots.push_back(slot);
+}
@@ -3,6 +3,8 @@
 #include <memory>
 #include <string>
 #include <fstream>
+#include <vector>
+#include <utility>
 #include "Process.h"
 
 class BackingStore {
@@ -15,11 +17,19 @@ public:
     void removeProcess(int pid);
     void displayContents() const;
 
+    // Page-sized swap slots for the paging allocator, a slot is reused once freed
+    int allocateSlot();
+    void writePage(int slot, int pid, int page);
+    bool readPage(int slot) const; // False if nothing was written to the slot
+    void freeSlot(int slot);
+
 private:
     std::string filename;
     std::unordered_map<int, std::shared_ptr<Process>> storedProcesses;
     std::ofstream outputFile;
     std::ifstream inputFile;
+    std::vector<std::pair<int, int>> slotContents; // slot -> (pid, page) last written to it, (-1, -1) while free or unwritten
+    std::vector<int> freeSlots;
 
     void openFiles();
     void closeFiles();
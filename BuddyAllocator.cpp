@@ -0,0 +1,126 @@
+#include "BuddyAllocator.h"
+#include <iostream>
+
+BuddyAllocator::BuddyAllocator() : configManager(nullptr), memorySize(0) {}
+
+void BuddyAllocator::initialize(ConfigurationManager* newConfigManager) {
+    configManager = newConfigManager;
+    memorySize = static_cast<int>(configManager->getMaxOverallMemory());
+    freeLists.assign(orderFor(memorySize) + 1, std::set<int>());
+    replacementPolicy = ReplacementPolicy::create(configManager->getPageReplacement());
+
+    // Memory that is not a power of two is carved into power-of-two roots, largest first,
+    // so every block stays aligned to its own size and never merges past the end of memory
+    int start = 0;
+    for (int order = static_cast<int>(freeLists.size()) - 1; order >= 0; order--) {
+        if (memorySize - start >= (1 << order)) {
+            freeLists[order].insert(start);
+            start += 1 << order;
+        }
+    }
+}
+
+bool BuddyAllocator::allocate(const Process& process) {
+    int order = orderFor(static_cast<int>(process.getMemorySize()));
+    if (order >= static_cast<int>(freeLists.size())) {
+        return false; // larger than memory
+    }
+
+    // smallest free block that fits
+    int current = order;
+    while (current < static_cast<int>(freeLists.size()) && freeLists[current].empty()) {
+        current++;
+    }
+    if (current == static_cast<int>(freeLists.size())) {
+        return false; // no sufficient free block found
+    }
+
+    int start = *freeLists[current].begin();
+    freeLists[current].erase(freeLists[current].begin());
+
+    // split down to the requested order, keeping the lower half and freeing the upper one
+    while (current > order) {
+        current--;
+        freeLists[current].insert(start + (1 << current));
+    }
+
+    allocations[process.getID()] = { start, order };
+    replacementPolicy->onInsert(process.getID());
+    usedMemory += 1 << order;
+    return true;
+}
+
+void BuddyAllocator::deallocate(int pid) {
+    auto it = allocations.find(pid);
+    if (it == allocations.end()) {
+        return;
+    }
+
+    int start = it->second.start;
+    int order = it->second.order;
+    usedMemory -= 1 << order;
+    allocations.erase(it);
+    replacementPolicy->onRemove(pid);
+
+    // merge with the buddy while it is free
+    int buddy;
+    while (order + 1 < static_cast<int>(freeLists.size()) && (buddy = findBuddy(start, order)) != -1) {
+        freeLists[order].erase(buddy);
+        start = std::min(start, buddy);
+        order++;
+    }
+    freeLists[order].insert(start);
+}
+
+int BuddyAllocator::swapOutVictimProcess(const ReplacementPolicy::SlotFilter& claimVictim) {
+    int pid = replacementPolicy->selectVictim(claimVictim, [this](int pid) { return referenceSource && referenceSource(pid); });
+
+    if (pid != -1) {
+        deallocate(pid);
+    }
+    return pid;
+}
+
+void BuddyAllocator::setReferenceSource(std::function<bool(int pid)> source) {
+    referenceSource = source;
+}
+
+void BuddyAllocator::tickReplacement() {
+    replacementPolicy->tick([this](int pid) { return referenceSource && referenceSource(pid); });
+}
+
+void BuddyAllocator::displayMemory() {
+    std::cout << "Free Blocks:" << std::endl;
+    for (size_t order = 0; order < freeLists.size(); order++) {
+        for (int start : freeLists[order]) {
+            std::cout << "Start: " << start << "\nSize: " << (1 << order) << std::endl << std::endl;
+        }
+    }
+}
+
+int BuddyAllocator::getUsedMemory() {
+    return usedMemory;
+}
+
+int BuddyAllocator::getInactiveMemory(const std::unordered_set<int>& runningProcessIDs) {
+    int inactiveMemory = 0;
+    for (const auto& entry : allocations) {
+        if (runningProcessIDs.find(entry.first) == runningProcessIDs.end()) {
+            inactiveMemory += 1 << entry.second.order;
+        }
+    }
+    return inactiveMemory;
+}
+
+int BuddyAllocator::orderFor(int size) {
+    int order = 0;
+    while ((1 << order) < size) {
+        order++;
+    }
+    return order;
+}
+
+int BuddyAllocator::findBuddy(int start, int order) {
+    int buddy = start ^ (1 << order);
+    return freeLists[order].count(buddy) ? buddy : -1;
+}
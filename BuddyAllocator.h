@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <functional>
+
+#include "Process.h"
+#include "ConfigurationManager.h"
+#include "ReplacementPolicy.h"
+
+// Buddy-system allocator. Memory is split into power-of-two blocks kept in one free list
+// per order; allocating splits a larger block in halves until it fits and freeing merges
+// a block with its buddy for as long as the buddy is free, so both take O(log n) steps
+// and external fragmentation stays bounded. Requests are rounded up to a power of two.
+class BuddyAllocator
+{
+public:
+	BuddyAllocator();
+
+	void initialize(ConfigurationManager* configManager);
+	bool allocate(const Process& process); // allocate memory for a process
+	void deallocate(int pid);
+	int swapOutVictimProcess(const ReplacementPolicy::SlotFilter& claimVictim); // swap out the process the replacement policy picks, claimVictim is asked only about the one it is about to take
+	void setReferenceSource(std::function<bool(int pid)> source); // Tests and clears a process's reference bit
+	void tickReplacement(); // Periodic reference sampling for aging policies
+	void displayMemory();
+
+	int getUsedMemory(); // returns active + idle processes, including the rounding up to a power of two
+	int getInactiveMemory(const std::unordered_set<int>& runningProcessIDs);
+
+private:
+	struct Allocation {
+		int start;
+		int order;
+	};
+
+	ConfigurationManager* configManager;
+	std::unique_ptr<ReplacementPolicy> replacementPolicy; // Slots are PIDs, whole processes are evicted
+	std::function<bool(int pid)> referenceSource;
+	int memorySize; // total memory size
+	std::vector<std::set<int>> freeLists; // Start addresses of the free blocks of size 2^order, lowest first
+	std::unordered_map<int, Allocation> allocations; // pid -> block
+	int usedMemory = 0;
+
+	static int orderFor(int size); // Smallest order whose block holds size
+	int findBuddy(int start, int order); // Start of the buddy if it is free at the same order, -1 otherwise
+};
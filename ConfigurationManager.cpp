@@ -7,7 +7,7 @@
 #include <random>
 
 ConfigurationManager::ConfigurationManager()
-	: numCPU(0), quantumCycles(0), preemptive(false), batchProcessFrequency(0), minInstructions(0), maxInstructions(0), delayPerExec(0), maxOverallMemory(0), minMemoryPerProcess(0), maxMemoryPerProcess(0), minPagePerProcess(0), maxPagePerProcess(0), memoryManagerAlgorithm("")
+	: numCPU(0), quantumCycles(0), preemptive(false), batchProcessFrequency(0), minInstructions(0), maxInstructions(0), delayPerExec(0), maxOverallMemory(0), minMemoryPerProcess(0), maxMemoryPerProcess(0), minPagePerProcess(0), maxPagePerProcess(0), memoryManagerAlgorithm(""), mlfqLevels(3), mlfqBoostCycles(100), simulationMode("realtime"), allocationPolicy("first-fit"), pageReplacement("clock"), tlbEntries(16), tlbAssociativity(4), tlbASIDTagged(true), pageTable("flat"), swapReadAhead(2), reclaimLowWatermark(0), reclaimHighWatermark(25)
 {}
 
 ConfigurationManager::~ConfigurationManager()
@@ -36,11 +36,9 @@ int ConfigurationManager::getNumCPU() const {
 	return numCPU;
 }
 
-std::string ConfigurationManager::getSchedulerAlgorithm() const {
-	// "rr" or "fcfs" or "sjf"
-	size_t firstQuote = schedulerAlgorithm.find('\"');
-	size_t secondQuote = schedulerAlgorithm.find('\"', firstQuote + 1);
-	return schedulerAlgorithm.substr(firstQuote + 1, secondQuote - firstQuote - 1);
+const std::string& ConfigurationManager::getSchedulerAlgorithm() const {
+	// "rr" or "fcfs" or "sjf" or "mlfq", unquoted once while parsing
+	return schedulerAlgorithm;
 }
 
 float ConfigurationManager::getQuantumCycles() const {
@@ -87,15 +85,69 @@ float ConfigurationManager::getMaxPagePerProcess() const {
 	return maxPagePerProcess;
 }
 
-std::string ConfigurationManager::getMemoryManagerAlgorithm() const {
-	std::string memoryManagerAlgorithm;
-	
-	if (minPagePerProcess == 1 && maxPagePerProcess == 1) {
-		memoryManagerAlgorithm = "flat";
-	}else {
-		memoryManagerAlgorithm = "paging";
+int ConfigurationManager::getMLFQLevels() const {
+	return mlfqLevels;
+}
+
+int ConfigurationManager::getMLFQQuantumCycles(int level) const {
+	// Without mlfq-quantum-cycles each level doubles the one above, starting from quantum-cycles
+	int quantum = quantumCycles > 0 ? static_cast<int>(quantumCycles) : 1;
+	for (int i = 0; i <= level; i++) {
+		if (i < static_cast<int>(mlfqQuantumCycles.size())) {
+			quantum = mlfqQuantumCycles[i];
+		}
+		else if (i > 0) {
+			quantum *= 2;
+		}
 	}
+	return quantum;
+}
+
+float ConfigurationManager::getMLFQBoostCycles() const {
+	return mlfqBoostCycles;
+}
+
+const std::string& ConfigurationManager::getSimulationMode() const {
+	return simulationMode;
+}
+
+const std::string& ConfigurationManager::getAllocationPolicy() const {
+	return allocationPolicy;
+}
+
+const std::string& ConfigurationManager::getPageReplacement() const {
+	return pageReplacement;
+}
+
+int ConfigurationManager::getTLBEntries() const {
+	return tlbEntries;
+}
+
+int ConfigurationManager::getTLBAssociativity() const {
+	return tlbAssociativity;
+}
 
+bool ConfigurationManager::isTLBASIDTagged() const {
+	return tlbASIDTagged;
+}
+
+const std::string& ConfigurationManager::getPageTable() const {
+	return pageTable;
+}
+
+int ConfigurationManager::getSwapReadAhead() const {
+	return swapReadAhead;
+}
+
+int ConfigurationManager::getReclaimLowWatermark() const {
+	return reclaimLowWatermark;
+}
+
+int ConfigurationManager::getReclaimHighWatermark() const {
+	return reclaimHighWatermark;
+}
+
+std::string ConfigurationManager::getMemoryManagerAlgorithm() const {
 	return memoryManagerAlgorithm;
 }
 
@@ -121,6 +173,7 @@ void ConfigurationManager::parseConfigFile() {
 
 		} else if (key == "scheduler") {
 			iss >> schedulerAlgorithm;
+			schedulerAlgorithm = unquote(schedulerAlgorithm); // Unquoted here so callers never have to re-parse the value
 
 		} else if (key == "quantum-cycles"){
 			iss >> quantumCycles;
@@ -165,20 +218,144 @@ void ConfigurationManager::parseConfigFile() {
 
 		} else if (key == "max-page-per-proc"){
 			iss >> maxPagePerProcess;
+
+		} else if (key == "mlfq-levels") {
+			iss >> mlfqLevels;
+			if (mlfqLevels < 1) {
+				throw std::runtime_error("Invalid value for mlfq-levels");
+			}
+
+		} else if (key == "mlfq-quantum-cycles") {
+			// One quantum per level, e.g. "mlfq-quantum-cycles 2 4 8"
+			mlfqQuantumCycles.clear();
+			int quantum;
+			while (iss >> quantum) {
+				if (quantum <= 0) {
+					throw std::runtime_error("Invalid value for mlfq-quantum-cycles");
+				}
+				mlfqQuantumCycles.push_back(quantum);
+			}
+			if (mlfqQuantumCycles.empty()) {
+				throw std::runtime_error("Invalid value for mlfq-quantum-cycles");
+			}
+
+		} else if (key == "mlfq-boost-cycles") {
+			iss >> mlfqBoostCycles;
+			if (mlfqBoostCycles <= 0) {
+				throw std::runtime_error("Invalid value for mlfq-boost-cycles");
+			}
+
+		} else if (key == "memory-manager") {
+			// Optional, "flat", "paging" or "buddy". Derived from the page range when omitted
+			iss >> memoryManagerAlgorithm;
+			memoryManagerAlgorithm = unquote(memoryManagerAlgorithm);
+			if (memoryManagerAlgorithm != "flat" && memoryManagerAlgorithm != "paging" && memoryManagerAlgorithm != "buddy") {
+				throw std::runtime_error("Invalid value for memory-manager");
+			}
+
+		} else if (key == "allocation-policy") {
+			// Free block the flat allocator picks: "first-fit", "best-fit", "worst-fit" or "next-fit"
+			iss >> allocationPolicy;
+			allocationPolicy = unquote(allocationPolicy);
+			if (allocationPolicy != "first-fit" && allocationPolicy != "best-fit" && allocationPolicy != "worst-fit" && allocationPolicy != "next-fit") {
+				throw std::runtime_error("Invalid value for allocation-policy");
+			}
+
+		} else if (key == "page-replacement") {
+			// Victim selection when memory is full: "fifo", "second-chance", "clock" or "lru"
+			iss >> pageReplacement;
+			pageReplacement = unquote(pageReplacement);
+			if (pageReplacement != "fifo" && pageReplacement != "second-chance" && pageReplacement != "clock" && pageReplacement != "lru") {
+				throw std::runtime_error("Invalid value for page-replacement");
+			}
+
+		} else if (key == "page-table") {
+			// Page table layout for paging: "flat", "two-level" or "inverted"
+			iss >> pageTable;
+			pageTable = unquote(pageTable);
+			if (pageTable != "flat" && pageTable != "two-level" && pageTable != "inverted") {
+				throw std::runtime_error("Invalid value for page-table");
+			}
+
+		} else if (key == "swap-read-ahead") {
+			// Pages after the faulted one brought in with it while frames are free, 0 pages in only what faults
+			iss >> swapReadAhead;
+			if (swapReadAhead < 0) {
+				throw std::runtime_error("Invalid value for swap-read-ahead");
+			}
+
+		} else if (key == "reclaim-low-watermark") {
+			// Percent of max-overall-mem, the memory thread starts evicting once free memory drops below it. 0, the default, disables it
+			iss >> reclaimLowWatermark;
+			if (reclaimLowWatermark < 0 || reclaimLowWatermark > 100) {
+				throw std::runtime_error("Invalid value for reclaim-low-watermark");
+			}
+
+		} else if (key == "reclaim-high-watermark") {
+			// Percent of max-overall-mem, background reclaim stops once this much is free again
+			iss >> reclaimHighWatermark;
+			if (reclaimHighWatermark < 0 || reclaimHighWatermark > 100) {
+				throw std::runtime_error("Invalid value for reclaim-high-watermark");
+			}
+
+		} else if (key == "tlb-entries") {
+			iss >> tlbEntries;
+			if (tlbEntries < 1) {
+				throw std::runtime_error("Invalid value for tlb-entries");
+			}
+
+		} else if (key == "tlb-associativity") {
+			// Ways per set, must divide tlb-entries. Equal to tlb-entries for a fully associative TLB
+			iss >> tlbAssociativity;
+			if (tlbAssociativity < 1) {
+				throw std::runtime_error("Invalid value for tlb-associativity");
+			}
+
+		} else if (key == "tlb-asid") {
+			// 1 tags entries with the process so they survive context switches, 0 flushes on every switch
+			int asidFlag;
+			iss >> asidFlag;
+			if (asidFlag != 0 && asidFlag != 1) {
+				throw std::runtime_error("Invalid value for tlb-asid");
+			}
+			tlbASIDTagged = asidFlag == 1;
+
+		} else if (key == "simulation-mode") {
+			// "realtime" sleeps for every cycle, "virtual" runs on a discrete-event clock
+			iss >> simulationMode;
+			simulationMode = unquote(simulationMode);
+			if (simulationMode != "realtime" && simulationMode != "virtual") {
+				throw std::runtime_error("Invalid value for simulation-mode");
+			}
 		} 
 	}
 
 	configFile.close();
 
+	if (tlbEntries % tlbAssociativity != 0) {
+		throw std::runtime_error("tlb-associativity must divide tlb-entries");
+	}
+	if (!mlfqQuantumCycles.empty() && static_cast<int>(mlfqQuantumCycles.size()) != mlfqLevels) {
+		throw std::runtime_error("mlfq-quantum-cycles must list one quantum per mlfq-levels");
+	}
+	if (reclaimLowWatermark > reclaimHighWatermark) {
+		throw std::runtime_error("reclaim-low-watermark must not exceed reclaim-high-watermark");
+	}
+	// The reclaimer could never free that much with a process resident, and would evict everything waiting trying to
+	if (reclaimLowWatermark > 0 && maxOverallMemory * reclaimHighWatermark / 100 > maxOverallMemory - minMemoryPerProcess) {
+		throw std::runtime_error("reclaim-high-watermark must leave room in max-overall-mem for a process of min-mem-per-proc");
+	}
+
 	// Determine memory manager algorithm
 		// If min-page-per-proc and max-page-per-proc are 1, 
 		// then the memory manager must use a flat memory allocator. 
 		// If its >1, its a paging allocator
-	if (minPagePerProcess == 1 && maxPagePerProcess == 1) {
-		memoryManagerAlgorithm = "flat";
+		// unless the memory-manager key names one explicitly
+	if (memoryManagerAlgorithm.empty()) {
+		memoryManagerAlgorithm = (minPagePerProcess == 1 && maxPagePerProcess == 1) ? "flat" : "paging";
+	}
 
-	} else {
-		memoryManagerAlgorithm = "paging";
+	if (memoryManagerAlgorithm == "paging") {
 
 		// Since paging will have set number of frames per process
 		int randomMemorySize = getRandomInt2N(minMemoryPerProcess, maxMemoryPerProcess);
@@ -210,10 +387,42 @@ void ConfigurationManager::printConfig() {
 	std::cout << "max-mem-per-proc: " << maxMemoryPerProcess << std::endl;
 	std::cout << "min-page-per-proc: " << minPagePerProcess << std::endl;
 	std::cout << "max-page-per-proc: " << maxPagePerProcess << std::endl;
-	std::cout << "memory-manager: " << memoryManagerAlgorithm << std::endl; // "flat" or "paging"
+	std::cout << "memory-manager: " << memoryManagerAlgorithm << std::endl; // "flat", "paging" or "buddy"
+	std::cout << "simulation-mode: " << simulationMode << std::endl;
+	if (memoryManagerAlgorithm == "flat") {
+		std::cout << "allocation-policy: " << allocationPolicy << std::endl;
+	}
+	std::cout << "page-replacement: " << pageReplacement << std::endl;
+	std::cout << "reclaim-low-watermark: " << reclaimLowWatermark << std::endl;
+	std::cout << "reclaim-high-watermark: " << reclaimHighWatermark << std::endl;
+	if (memoryManagerAlgorithm == "paging") {
+		std::cout << "page-table: " << pageTable << std::endl;
+		std::cout << "swap-read-ahead: " << swapReadAhead << std::endl;
+	}
+	std::cout << "tlb-entries: " << tlbEntries << std::endl;
+	std::cout << "tlb-associativity: " << tlbAssociativity << std::endl;
+	std::cout << "tlb-asid: " << tlbASIDTagged << std::endl;
+	if (getSchedulerAlgorithm() == "mlfq") {
+		std::cout << "mlfq-levels: " << mlfqLevels << std::endl;
+		std::cout << "mlfq-quantum-cycles:";
+		for (int i = 0; i < mlfqLevels; i++) {
+			std::cout << " " << getMLFQQuantumCycles(i);
+		}
+		std::cout << std::endl;
+		std::cout << "mlfq-boost-cycles: " << mlfqBoostCycles << std::endl;
+	}
 	std::cout << "--------------------------" << std::endl;
 }
 
+std::string ConfigurationManager::unquote(const std::string& value) {
+	size_t firstQuote = value.find('\"');
+	if (firstQuote == std::string::npos) {
+		return value;
+	}
+	size_t secondQuote = value.find('\"', firstQuote + 1);
+	return value.substr(firstQuote + 1, secondQuote - firstQuote - 1);
+}
+
 int ConfigurationManager::getRandomInt2N(int min, int max) {
 
 	int minExp = std::ceil(std::log2(min));
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class ConfigurationManager
 {
@@ -13,7 +14,7 @@ public:
 	bool isInitialized(); // Returns true if the configuration manager has been initialized
 
 	int getNumCPU() const; // Returns the number of CPUs
-	std::string getSchedulerAlgorithm() const; // Returns the scheduler algorithm
+	const std::string& getSchedulerAlgorithm() const; // Returns the scheduler algorithm
 	float getQuantumCycles() const; // Returns the quantum cycles
 	bool isPreemptive() const; // Returns true if the scheduler is preemptive
 	float getBatchProcessFrequency() const; // Returns the batch process frequency
@@ -27,6 +28,19 @@ public:
 	float getMaxPagePerProcess() const; // Returns the maximum number of pages per process
 	std::string getMemoryManagerAlgorithm() const; // Returns the memory manager algorithm
 	float getMaxFrames() const; // Returns the maximum number of frames
+	int getMLFQLevels() const; // Returns the number of MLFQ priority levels
+	int getMLFQQuantumCycles(int level) const; // Returns the quantum of an MLFQ level
+	float getMLFQBoostCycles() const; // Returns the number of cycles between MLFQ priority boosts
+	const std::string& getSimulationMode() const; // Returns "realtime" or "virtual"
+	const std::string& getAllocationPolicy() const; // Returns the flat allocator's fit policy
+	const std::string& getPageReplacement() const; // Returns the replacement policy used when memory is full
+	int getTLBEntries() const; // Returns the number of entries in each core's TLB
+	int getTLBAssociativity() const; // Returns the number of ways per TLB set
+	bool isTLBASIDTagged() const; // Returns true if TLB entries survive context switches
+	const std::string& getPageTable() const; // Returns the paging allocator's page table layout
+	int getSwapReadAhead() const; // Returns how many neighbouring pages each page-in reads along with the faulted one
+	int getReclaimLowWatermark() const; // Returns the free memory percentage below which background reclaim starts
+	int getReclaimHighWatermark() const; // Returns the free memory percentage background reclaim restores
 
 private:
 	void parseConfigFile();	// Parses the config file and sets the configuration values
@@ -51,6 +65,22 @@ private:
 
 	float maxFrames;
 
+	int mlfqLevels;
+	std::vector<int> mlfqQuantumCycles;
+	float mlfqBoostCycles;
+
+	std::string simulationMode;
+	std::string allocationPolicy;
+	std::string pageReplacement;
+	int tlbEntries;
+	int tlbAssociativity;
+	bool tlbASIDTagged;
+	std::string pageTable;
+	int swapReadAhead;
+	int reclaimLowWatermark;
+	int reclaimHighWatermark;
+
+	static std::string unquote(const std::string& value); // Strips surrounding double quotes, if any
 	int getRandomInt2N(int min, int max); // Randomizer for the process details wherein number = 2^n
 };
 
@@ -41,7 +41,7 @@ void ConsoleManager::switchScreen(const std::string consoleName) {
 			// Check if process is finished
 			std::shared_ptr<Process> process = resourceManager.findProcessByName(processName);
 			
-			if (!process->isFinished()) {
+			if (process && !process->isFinished()) { // Finished processes are collected and no longer resolve
 				previousConsole = currentConsole;
 				currentConsole = consoles[consoleName];
 				system("cls");
@@ -108,9 +108,13 @@ ResourceManager& ConsoleManager::getResourceManager() {
 void ConsoleManager::createProcessScreen(const std::string processName) {
 	// Create new process
 	std::shared_ptr<Process> processPointer = resourceManager.createProcess(processName);
+	if (!processPointer) {
+		std::cout << "Process already exists or has existed. Please provide a different name." << std::endl;
+		return;
+	}
 
 	// Create new process screen
-	auto processScreen = std::make_shared<ProcessScreen>(processPointer);
+	auto processScreen = std::make_shared<ProcessScreen>(resourceManager.getProcessTable(), processPointer->getHandle());
 
 	// Add process screen to console manager
 	addConsole(processScreen);
@@ -130,9 +134,9 @@ bool ConsoleManager::ifProcessExists(std::string name) {
 }
 
 bool ConsoleManager::isProcessFinished(std::string name) {
-	if (ifProcessExists(name)) {
-		std::shared_ptr<Process> foundProcess = resourceManager.getScheduler()->getProcessByName(name);
-		return foundProcess->isFinished();
+	if (resourceManager.processExists(name)) {
+		std::shared_ptr<Process> foundProcess = resourceManager.findProcessByName(name);
+		return !foundProcess || foundProcess->isFinished(); // Collected once finished, only the name stays taken
 	}
 
 	return false;
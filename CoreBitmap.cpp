@@ -0,0 +1,61 @@
+#include "CoreBitmap.h"
+
+#include <bitset>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+CoreBitmap::CoreBitmap(int numCores)
+    : numCores(numCores), numWords((numCores + 63) / 64), words(new std::atomic<uint64_t>[(numCores + 63) / 64]) {
+    for (int i = 0; i < numWords; i++) {
+        words[i].store(0, std::memory_order_relaxed); // Every core starts busy until its thread is up
+    }
+}
+
+void CoreBitmap::setIdle(int coreID) {
+    int index = coreID - 1;
+    words[index / 64].fetch_or(uint64_t(1) << (index % 64), std::memory_order_release);
+}
+
+void CoreBitmap::setBusy(int coreID) {
+    int index = coreID - 1;
+    words[index / 64].fetch_and(~(uint64_t(1) << (index % 64)), std::memory_order_release);
+}
+
+bool CoreBitmap::isIdle(int coreID) const {
+    int index = coreID - 1;
+    return (words[index / 64].load(std::memory_order_acquire) >> (index % 64)) & 1;
+}
+
+int CoreBitmap::findIdle() const {
+    for (int i = 0; i < numWords; i++) {
+        uint64_t word = words[i].load(std::memory_order_acquire);
+        if (word != 0) {
+            return i * 64 + findFirstSet(word) + 1;
+        }
+    }
+    return 0;
+}
+
+int CoreBitmap::countBusy() const {
+    int idle = 0;
+    for (int i = 0; i < numWords; i++) {
+        idle += static_cast<int>(std::bitset<64>(words[i].load(std::memory_order_acquire)).count());
+    }
+    return numCores - idle;
+}
+
+int CoreBitmap::size() const {
+    return numCores;
+}
+
+int CoreBitmap::findFirstSet(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
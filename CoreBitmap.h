@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// Lock-free bitmap of idle cores, one bit per core (bit set = idle).
+// Cores flip their own bit when they take or release a process, so the
+// Scheduler can find a free core and the reporting layer can count busy
+// cores without touching any per-core lock.
+class CoreBitmap
+{
+public:
+    explicit CoreBitmap(int numCores);
+
+    void setIdle(int coreID); // Core IDs are 1-based like CoreWorker::getID
+    void setBusy(int coreID);
+    bool isIdle(int coreID) const;
+
+    int findIdle() const; // ID of the lowest idle core, 0 if every core is busy
+    int countBusy() const;
+    int size() const;
+
+private:
+    int numCores;
+    int numWords;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+
+    static int findFirstSet(uint64_t word); // Index of the lowest set bit, word must be non-zero
+};
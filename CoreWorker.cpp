@@ -2,8 +2,8 @@
 
 #include <iostream>
 
-CoreWorker::CoreWorker(int id, float delayPerExec, float quantumSlice) 
-    : id(id), delayPerExec(delayPerExec), quantumSlice(quantumSlice), running(false), processAssigned(false) {}
+CoreWorker::CoreWorker(int id, SimulationClock* clock, CoreBitmap* idleCores, std::unique_ptr<TLB> tlb, float delayPerExec, float quantumSlice) 
+    : id(id), running(false), processAssigned(false), localQueue(LOCAL_QUEUE_CAPACITY), clock(clock), idleCores(idleCores), tlb(std::move(tlb)), delayPerExec(delayPerExec), quantumSlice(quantumSlice) {}
 
 CoreWorker::~CoreWorker() {
     stop();
@@ -17,20 +17,33 @@ std::shared_ptr<Process> CoreWorker::getCurrentProcess() {
 	return currentProcess;
 }
 
-void CoreWorker::setProcess(std::shared_ptr<Process> process) {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    currentProcess = process;
-    processAssigned = true;
+void CoreWorker::setProcess(std::shared_ptr<Process> process, int quantum) {
+    {
+        std::lock_guard<std::mutex> lock(coreMutex);
+        currentProcess = process;
+        currentProcess->markDispatched(clock->now());
+        tlb->switchTo(currentProcess->getID());
+        currentQuantum = quantum > 0 ? quantum : static_cast<int>(quantumSlice);
+        processAssigned = true;
+        idleCores->setBusy(id);
+    }
+    clock->wake(clockParticipant);
+    processAvailable.notify_one(); // Unpark the core thread
 }
 
 void CoreWorker::runProcess() {
     // For SJF and FCFS
-    if (quantumSlice == 0) {
+    if (currentQuantum == 0) {
         // While there is still a process, run
         while (currentProcess && !currentProcess->isFinished()) {
-            totalActiveTicks++;
-            currentProcess->execute();
-            std::this_thread::sleep_for(std::chrono::duration<float>(delayPerExec));
+            if (preemptRequested.load(std::memory_order_acquire)) {
+                acknowledgePreemption();
+                return;
+            }
+            if (!executeTick()) {
+                return; // The process waits off-core while its page is brought in
+            }
+            waitForNextTick();
         }
 
         // Process is finished, notify Scheduler
@@ -39,33 +52,154 @@ void CoreWorker::runProcess() {
         }
     }
 
-    // For RR
+    // For RR and MLFQ
     else {
-        for (int i = 0; i < quantumSlice; i++) {
+        for (int i = 0; i < currentQuantum; i++) {
             if (currentProcess->isFinished()) {
                 finishProcess();
                 return;
             }
-            currentProcess->execute();
-            std::this_thread::sleep_for(std::chrono::duration<float>(delayPerExec));
-        }
-        totalActiveTicks++;
-        // Process is not finished, notify Scheduler
-        if (processCompletionCallback) {
-            processCompletionCallback(currentProcess);
+            if (preemptRequested.load(std::memory_order_acquire)) {
+                acknowledgePreemption();
+                return;
+            }
+            if (!executeTick()) {
+                return; // The process waits off-core while its page is brought in
+            }
+            waitForNextTick();
         }
-
-        // Reset the current process to ensure it gets requeued
-        currentProcess.reset();
-        processAssigned = false;
+        // Quantum expired, release the core and let the Scheduler requeue the process
+        finishProcess();
     }
 }
 
 
 void CoreWorker::finishProcess() {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    currentProcess.reset(); // Reset the current process
-    processAssigned = false; // No more process assigned
+    std::shared_ptr<Process> releasedProcess;
+    std::function<void(std::shared_ptr<Process>)> callback;
+    {
+        std::lock_guard<std::mutex> lock(coreMutex);
+        releasedProcess = currentProcess;
+        callback = processCompletionCallback;
+        currentProcess.reset(); // Reset the current process
+        processAssigned = false; // No more process assigned
+        idleCores->setIdle(id);
+        preemptRequested = false; // A pending preemption is moot once the core is released
+    }
+
+    if (releasedProcess && releasedProcess->isFinished()) {
+        releasedProcess->markCompleted(clock->now());
+    }
+
+    // Notify the Scheduler only after the core is marked available so it can dispatch to it right away
+    if (callback && releasedProcess) {
+        callback(releasedProcess);
+    }
+}
+
+bool CoreWorker::executeTick() {
+    int page = -1;
+    if (!checkSwappedIn() || !touchCurrentPage(page)) {
+        return false;
+    }
+
+    totalActiveTicks++;
+    currentProcess->execute();
+    currentProcess->markReferenced();
+
+    // The first write through a clean TLB entry sets the dirty bit in the page table, like a hardware walker
+    if (page >= 0 && currentProcess->didWriteMemory() && tlb->markDirty(currentProcess->getID(), page) && pageDirtyCallback) {
+        pageDirtyCallback(currentProcess->getID(), page);
+    }
+    return true;
+}
+
+bool CoreWorker::checkSwappedIn() {
+    // Only a process evicted while it waited in a queue is SWAPPED, its first instruction sets it RUNNING.
+    // The transition loses to a prefetch that already brought the process back in.
+    if (!swapInCallback || currentProcess->getState() != Process::State::SWAPPED
+        || !currentProcess->transition(Process::State::SWAPPED, Process::State::BLOCKED)) {
+        return true;
+    }
+
+    // Released like a page fault, the memory manager requeues the process once its image is back
+    std::shared_ptr<Process> swappedProcess = currentProcess;
+    swappedProcess->setCore(-1);
+    finishProcess();
+    swapInCallback(swappedProcess);
+    return false;
+}
+
+bool CoreWorker::touchCurrentPage(int& page) {
+    // A sleeping process burns its tick without touching memory
+    if (currentProcess->getState() == Process::State::WAITING) {
+        return true;
+    }
+
+    page = currentProcess->getCurrentPage();
+    if (tlb->lookup(currentProcess->getID(), page)) {
+        return true; // Cached only if walked since the page's reference bit was last cleared, so the bit is still set
+    }
+
+    // TLB miss, without demand paging every page is resident
+    if (!pageTableWalk) {
+        tlb->insert(currentProcess->getID(), page);
+        return true;
+    }
+    if (pageTableWalk(*currentProcess, *tlb)) {
+        return true; // The walk cached the translation
+    }
+
+    // Release the core before raising the fault so the page-in cannot requeue a process that is still on it
+    std::shared_ptr<Process> faultedProcess = currentProcess;
+    faultedProcess->setState(Process::State::BLOCKED);
+    faultedProcess->setCore(-1);
+    finishProcess(); // The Scheduler leaves BLOCKED processes out of the ready queue
+    pageFaultCallback(faultedProcess);
+    return false;
+}
+
+bool CoreWorker::requestPreemption() {
+    {
+        std::lock_guard<std::mutex> lock(coreMutex);
+        if (!processAssigned || preemptRequested) {
+            return false; // Nothing to preempt, or a preemption is already in flight
+        }
+        preemptRequestedAt = std::chrono::steady_clock::now();
+        preemptRequested.store(true, std::memory_order_release);
+    }
+    processAvailable.notify_one(); // Cut the current tick short so the core reaches an instruction boundary
+    return true;
+}
+
+bool CoreWorker::isPreemptionPending() {
+    return preemptRequested.load(std::memory_order_acquire);
+}
+
+void CoreWorker::acknowledgePreemption() {
+    // The victim's progress lives in its Process, clearing the core assignment completes the context save
+    currentProcess->setCore(-1);
+
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - preemptRequestedAt);
+    totalPreemptions++;
+    totalPreemptionLatency += latency.count();
+
+    // Hand the victim back to the Scheduler, which requeues it since it is not finished
+    finishProcess();
+}
+
+void CoreWorker::waitForNextTick() {
+    if (clock->isVirtual()) {
+        // On the virtual clock the tick costs no real time, preemption is picked up at the next boundary
+        clock->sleepFor(clockParticipant, SimulationClock::toDuration(delayPerExec));
+        return;
+    }
+
+    // Sleep for one delay-per-exec period, waking early on a preemption request or stop
+    std::unique_lock<std::mutex> lock(coreMutex);
+    processAvailable.wait_for(lock, std::chrono::duration<float>(delayPerExec), [this] {
+        return !running || preemptRequested.load(std::memory_order_acquire);
+        });
 }
 
 bool CoreWorker::isAvailable() {
@@ -84,15 +218,17 @@ int CoreWorker::getID() {
 
 void CoreWorker::start() {
     running = true;
+    idleCores->setIdle(id);
+    clock->addParticipant(clockParticipant);
     coreThread = std::thread(&CoreWorker::run, this); // Start the core thread
 }
 
 void CoreWorker::stop() {
-    running = false;
     {
         std::lock_guard<std::mutex> lock(coreMutex);
         running = false;
     }
+    processAvailable.notify_all(); // Wake the core thread if it is parked
     if (coreThread.joinable()) {
         coreThread.join();
     }
@@ -107,15 +243,59 @@ void CoreWorker::run() {
                 break;
             }
         }
-        totalCPUTicks++;
-        if (processAssigned) {
+
+        if (isAssignedProcess() || acquireNextProcess()) {
             runProcess();
+            continue;
         }
-        else {
-            totalIdleTicks++;
-            // TODO: might need to add delay here
+
+        std::unique_lock<std::mutex> lock(coreMutex);
+        if (!processAssigned && running && localQueue.empty()) {
+            // Park until the Scheduler assigns or queues a process, the idle time is accounted for on wakeup
+            parked = true;
+            parkedSinceTick = clock->getTick();
+            clock->wait(clockParticipant, lock, processAvailable, [this] { return !running || processAssigned || !localQueue.empty(); });
+            parked = false;
+            totalIdleTicks += clock->getTick() - parkedSinceTick;
         }
     }
+
+    clock->removeParticipant(clockParticipant);
+}
+
+bool CoreWorker::acquireNextProcess() {
+    std::shared_ptr<Process> next;
+
+    // Own run queue first, then steal from the peers starting after this core to spread contention
+    if (!localQueue.pop(next)) {
+        for (size_t i = 0; i < peers.size() && !next; i++) {
+            peers[(id + i) % peers.size()]->stealProcess(next);
+        }
+    }
+
+    if (!next) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(coreMutex);
+        if (!processAssigned) {
+            next->setCore(id);
+            next->markDispatched(clock->now());
+            tlb->switchTo(next->getID());
+            currentProcess = next;
+            currentQuantum = static_cast<int>(quantumSlice);
+            processAssigned = true;
+            idleCores->setBusy(id);
+            return true;
+        }
+    }
+
+    // The Scheduler assigned a process directly in the meantime, keep the pulled one for later
+    if (!localQueue.push(next) && processCompletionCallback) {
+        processCompletionCallback(next);
+    }
+    return true;
 }
 
 // Set the process completion callback
@@ -124,6 +304,63 @@ void CoreWorker::setProcessCompletionCallback(std::function<void(std::shared_ptr
     processCompletionCallback = callback;
 }
 
+void CoreWorker::setPageFaultHandler(std::function<bool(const Process&, TLB&)> walkPageTable, std::function<void(std::shared_ptr<Process>)> onPageFault,
+    std::function<void(int pid, int page)> onPageDirtied) {
+    std::lock_guard<std::mutex> lock(coreMutex);
+    pageTableWalk = walkPageTable;
+    pageFaultCallback = onPageFault;
+    pageDirtyCallback = onPageDirtied;
+}
+
+void CoreWorker::setSwapInHandler(std::function<void(std::shared_ptr<Process>)> onSwappedOut) {
+    std::lock_guard<std::mutex> lock(coreMutex);
+    swapInCallback = onSwappedOut;
+}
+
+void CoreWorker::invalidateTLBEntry(int pid, int page) {
+    tlb->invalidate(pid, page);
+}
+
+bool CoreWorker::enqueueProcess(std::shared_ptr<Process> process) {
+    if (!localQueue.push(process)) {
+        return false;
+    }
+
+    // Take the lock so the wakeup cannot slip in between the parked thread's check and its wait
+    {
+        std::lock_guard<std::mutex> lock(coreMutex);
+    }
+    clock->wake(clockParticipant);
+    processAvailable.notify_one();
+    return true;
+}
+
+bool CoreWorker::stealProcess(std::shared_ptr<Process>& process) {
+    return localQueue.pop(process);
+}
+
+int CoreWorker::getLoad() {
+    return static_cast<int>(localQueue.size()) + (isAssignedProcess() ? 1 : 0);
+}
+
+void CoreWorker::setPeers(std::vector<CoreWorker*> newPeers) {
+    peers = newPeers;
+}
+
+std::vector<long long> CoreWorker::getPreemptionStats() {
+    return { totalPreemptions, totalPreemptionLatency };
+}
+
+std::vector<long long> CoreWorker::getTLBStats() {
+    return tlb->getStats();
+}
+
 std::vector<long long> CoreWorker::getStats() {
-    return { totalCPUTicks, totalActiveTicks, totalIdleTicks };
+    std::lock_guard<std::mutex> lock(coreMutex);
+    long long activeTicks = totalActiveTicks;
+    long long idleTicks = totalIdleTicks;
+    if (parked) {
+        idleTicks += clock->getTick() - parkedSinceTick; // Include the idle span still in progress
+    }
+    return { activeTicks + idleTicks, activeTicks, idleTicks };
 }
@@ -3,24 +3,33 @@
 #include <thread>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <vector>
 
 #include "Process.h"
-
-
+#include "ReadyQueue.h"
+#include "SimulationClock.h"
+#include "CoreBitmap.h"
+#include "TLB.h"
 
 class CoreWorker
 {
 public:
-    CoreWorker(int id, float delayPerExec, float quantumSlice = 0);
+    CoreWorker(int id, SimulationClock* clock, CoreBitmap* idleCores, std::unique_ptr<TLB> tlb, float delayPerExec, float quantumSlice = 0);
     ~CoreWorker();
 
     std::shared_ptr<Process> getCurrentProcess();
-    void setProcess(std::shared_ptr<Process> process);
+    void setProcess(std::shared_ptr<Process> process, int quantum = 0); // A quantum of 0 uses the core's own quantum slice
     void runProcess();
     void finishProcess();
 
+    // Preemption, the core hands its process back at the next instruction boundary
+    bool requestPreemption(); // False if the core is idle or already being preempted
+    bool isPreemptionPending();
+
     bool isAvailable();
 	bool isAssignedProcess();
     int getID();
@@ -30,7 +39,24 @@ public:
 
     void setProcessCompletionCallback(std::function<void(std::shared_ptr<Process>)> callback);
 
+    // Demand paging, the core walks the page table on a TLB miss, hands faulting processes to onPageFault
+    // and reports the first write to each page through onPageDirtied
+    void setPageFaultHandler(std::function<bool(const Process&, TLB&)> walkPageTable, std::function<void(std::shared_ptr<Process>)> onPageFault,
+        std::function<void(int pid, int page)> onPageDirtied);
+    void invalidateTLBEntry(int pid, int page); // Shootdown after the page was evicted
+    void setSwapInHandler(std::function<void(std::shared_ptr<Process>)> onSwappedOut); // Told about dispatched processes whose image is in the backing store
+
+    // Local run queue
+    bool enqueueProcess(std::shared_ptr<Process> process); // Queue a process behind the running one, false if the run queue is full
+    bool stealProcess(std::shared_ptr<Process>& process); // Take a queued process on behalf of another core
+    int getLoad(); // Running process + queued processes
+    void setPeers(std::vector<CoreWorker*> newPeers); // Cores this core may steal from when its run queue is empty
+
+    static const size_t LOCAL_QUEUE_CAPACITY = 8;
+
     std::vector<long long> getStats();
+    std::vector<long long> getPreemptionStats(); // Preemption count and total request-to-handoff latency in microseconds
+    std::vector<long long> getTLBStats(); // TLB hits, misses and flushes
 
 private:
     int id;
@@ -38,17 +64,47 @@ private:
     bool running;
     bool processAssigned;
     std::mutex coreMutex;
+    std::condition_variable processAvailable; // Wakes the core thread when a process is assigned or a preemption is requested
     std::shared_ptr<Process> currentProcess;
 
+    ReadyQueue localQueue; // Processes handed to this core ahead of time, stealable by peers
+    std::vector<CoreWorker*> peers;
+
+    SimulationClock* clock;
+    SimulationClock::Participant clockParticipant;
+
+    CoreBitmap* idleCores; // Shared with the Scheduler, this core's bit is flipped whenever processAssigned changes
+    std::unique_ptr<TLB> tlb; // Translations of the processes run on this core, consulted before every instruction
+
     float delayPerExec = 0;
     float quantumSlice = 0;
+    int currentQuantum = 0; // Quantum of the process being run, 0 runs it to completion
 
     void run();
+    void waitForNextTick();
+    void acknowledgePreemption(); // Save the victim's context and release it to the Scheduler
+    bool acquireNextProcess(); // Pull the next process from the local run queue or a peer's, true if one was assigned
     std::function<void(std::shared_ptr<Process>)> processCompletionCallback;
+    std::function<bool(const Process&, TLB&)> pageTableWalk; // Unset unless the memory manager pages on demand
+    std::function<void(std::shared_ptr<Process>)> pageFaultCallback;
+    std::function<void(int pid, int page)> pageDirtyCallback;
+    std::function<void(std::shared_ptr<Process>)> swapInCallback; // Unset unless the memory manager swaps whole processes
+    bool executeTick(); // Run one instruction, false if it faulted and the process was released
+    bool checkSwappedIn(); // False if the process was swapped out while queued and has been released to be swapped in
+    bool touchCurrentPage(int& page); // Translate the page the next instruction touches, -1 if it touches none
+
+    // Stat trackers (total CPU ticks = active + idle)
+    std::atomic<long long> totalActiveTicks{ 0 };
+    std::atomic<long long> totalIdleTicks{ 0 };
+
+    // Preemption protocol
+    std::atomic<bool> preemptRequested{ false };
+    std::chrono::steady_clock::time_point preemptRequestedAt;
+    std::atomic<long long> totalPreemptions{ 0 };
+    std::atomic<long long> totalPreemptionLatency{ 0 };
 
-    // Stat trackers
-    long long totalCPUTicks = 0;
-    long long totalActiveTicks = 0;
-    long long totalIdleTicks = 0;
+    // Idle tracking while the core is parked
+    bool parked = false;
+    long long parkedSinceTick = 0; // Clock tick the core parked at
 
 };
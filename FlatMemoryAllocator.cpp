@@ -2,108 +2,189 @@
 #include <iostream>
 #include <algorithm>
 
-FlatMemoryAllocator::FlatMemoryAllocator() {
+FlatMemoryAllocator::FlatMemoryAllocator() : configManager(nullptr), policy(FitPolicy::FIRST_FIT), memorySize(0), usedMemory(0), treeLeaves(1), nextFitStart(0) {
     srand(static_cast<unsigned int>(time(nullptr))); // Initialize random seed once
 }
 
 void FlatMemoryAllocator::initialize(ConfigurationManager* newConfigManager) {
     configManager = newConfigManager;
     memorySize = static_cast<int>(configManager->getMaxOverallMemory());
-    memoryBlocks.push_back({ 0, memorySize, true }); // Initialize with a single free block of the entire memory
-}
 
-void printBlockInfo(const MemoryBlock& block) {
-	std::cout << "Start: " << block.start
-		<< "\nSize: " << block.size
-		<< "\nStatus: " << (block.isFree ? "Free" : "Allocated") << std::endl << std::endl;
-}
+    const std::string& policyName = configManager->getAllocationPolicy();
+    if (policyName == "best-fit") {
+        policy = FitPolicy::BEST_FIT;
+    }
+    else if (policyName == "worst-fit") {
+        policy = FitPolicy::WORST_FIT;
+    }
+    else if (policyName == "next-fit") {
+        policy = FitPolicy::NEXT_FIT;
+    }
+    else {
+        policy = FitPolicy::FIRST_FIT;
+    }
 
-bool FlatMemoryAllocator::allocate(Process process) {
-    int processSize = static_cast<int>(process.getMemorySize());
+    replacementPolicy = ReplacementPolicy::create(configManager->getPageReplacement());
 
-    for (auto& block : memoryBlocks) {
+    treeLeaves = 1;
+    while (treeLeaves < memorySize) {
+        treeLeaves *= 2;
+    }
+    largestFree.assign(2 * treeLeaves, 0);
 
-        // check if block is free and has enough space for the process
-        if (block.isFree && block.size >= processSize) {
+    addFreeBlock(0, memorySize); // Initialize with a single free block of the entire memory
+}
 
-            int currBlockSize = block.size;
+bool FlatMemoryAllocator::allocate(const Process& process) {
+    int processSize = static_cast<int>(process.getMemorySize());
 
-            block.isFree = false;
-            block.size = process.getMemorySize();
+    int start = findFreeBlock(processSize);
+    if (start == -1) {
+        return false; // no sufficient free block found
+    }
 
-            processMemoryMap[process.getID()] = block.start;
+    int blockSize = freeByAddress[start];
+    removeFreeBlock(start, blockSize);
 
-            // split block if it has more space than the process
-            if (currBlockSize > process.getMemorySize()) {
-                memoryBlocks.push_back({ block.start + ((int) process.getMemorySize()), currBlockSize - ((int) process.getMemorySize()), true});
-            }
-            
-            return true;
-        }
+    // split block if it has more space than the process
+    if (blockSize > processSize) {
+        addFreeBlock(start + processSize, blockSize - processSize);
     }
-    return false; // no sufficient free block found
+
+    processMemoryMap[process.getID()] = { start, processSize, false };
+    replacementPolicy->onInsert(process.getID());
+    usedMemory += processSize;
+    nextFitStart = start + processSize;
+    return true;
 }
 
 void FlatMemoryAllocator::deallocate(int pid) {
     auto it = processMemoryMap.find(pid);
+    if (it == processMemoryMap.end()) {
+        return;
+    }
 
-    // find block with the process
-    if (it != processMemoryMap.end()) {
-        for (auto& block : memoryBlocks) {
-
-            // check if block is the one with the process
-            if (block.start == it->second) {
-                block.isFree = true;
-                processMemoryMap.erase(it);
-                mergeFreeBlocks(); // Merge adjacent free blocks after deallocation
-                break;
-            }
+    int start = it->second.start;
+    int size = it->second.size;
+    usedMemory -= size;
+    processMemoryMap.erase(it);
+    replacementPolicy->onRemove(pid);
+
+    // Coalesce with the free neighbours on either side
+    auto next = freeByAddress.find(start + size);
+    if (next != freeByAddress.end()) {
+        int nextSize = next->second;
+        removeFreeBlock(start + size, nextSize);
+        size += nextSize;
+    }
+
+    auto prev = freeByAddress.lower_bound(start);
+    if (prev != freeByAddress.begin()) {
+        --prev;
+        if (prev->first + prev->second == start) {
+            int prevStart = prev->first;
+            int prevSize = prev->second;
+            removeFreeBlock(prevStart, prevSize);
+            start = prevStart;
+            size += prevSize;
         }
     }
+
+    addFreeBlock(start, size);
 }
 
-int FlatMemoryAllocator::swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs) {
-    if (processMemoryMap.empty()) {
-        return -1;
+int FlatMemoryAllocator::swapOutVictimProcess(const ReplacementPolicy::SlotFilter& claimVictim) {
+    int pid = replacementPolicy->selectVictim(claimVictim, [this](int pid) { return referenceSource && referenceSource(pid); });
+
+    if (pid != -1) {
+        deallocate(pid);
     }
+    return pid;
+}
 
-    std::vector<int> nonRunningProcesses;
-    for (const auto& entry : processMemoryMap) {
-        if (runningProcessIDs.find(entry.first) == runningProcessIDs.end()) {
-            nonRunningProcesses.push_back(entry.first);
+void FlatMemoryAllocator::setReferenceSource(std::function<bool(int pid)> source) {
+    referenceSource = source;
+}
+
+void FlatMemoryAllocator::tickReplacement() {
+    replacementPolicy->tick([this](int pid) { return referenceSource && referenceSource(pid); });
+}
+
+int FlatMemoryAllocator::findFreeBlock(int size) {
+    switch (policy) {
+    case FitPolicy::BEST_FIT: {
+        // Smallest block that fits, lowest address among equals
+        auto it = freeBySize.lower_bound({ size, 0 });
+        return it != freeBySize.end() ? it->second : -1;
+    }
+    case FitPolicy::WORST_FIT: {
+        if (freeBySize.empty() || freeBySize.rbegin()->first < size) {
+            return -1;
         }
+        return freeBySize.rbegin()->second;
+    }
+    case FitPolicy::NEXT_FIT: {
+        // Resume after the last allocation, wrapping around to the start of memory
+        int start = findFirstFit(nextFitStart, size);
+        return start != -1 ? start : findFirstFit(0, size);
     }
+    default:
+        return findFirstFit(0, size);
+    }
+}
+
+int FlatMemoryAllocator::findFirstFit(int from, int size) {
+    return findFirstFit(1, 0, treeLeaves, from, size);
+}
 
-    if (nonRunningProcesses.empty()) {
+int FlatMemoryAllocator::findFirstFit(int node, int lo, int hi, int from, int size) {
+    // Skip subtrees that end before from or hold no block big enough, so only one path is walked to the end
+    if (hi <= from || largestFree[node] < size) {
         return -1;
     }
+    if (hi - lo == 1) {
+        return lo;
+    }
 
-    int randIndex = rand() % nonRunningProcesses.size(); // get random index
-    int pid = nonRunningProcesses[randIndex];
-    deallocate(pid);
-    return pid;
+    int mid = (lo + hi) / 2;
+    int start = findFirstFit(2 * node, lo, mid, from, size);
+    return start != -1 ? start : findFirstFit(2 * node + 1, mid, hi, from, size);
 }
 
-void FlatMemoryAllocator::mergeFreeBlocks() {
+void FlatMemoryAllocator::addFreeBlock(int start, int size) {
+    freeByAddress[start] = size;
+    freeBySize.insert({ size, start });
+    setLargestFree(start, size);
+}
 
-    // Sort memory blocks by start address
-    std::sort(memoryBlocks.begin(), memoryBlocks.end(), [](const MemoryBlock& a, const MemoryBlock& b) {
-        return a.start < b.start;
-        });
+void FlatMemoryAllocator::removeFreeBlock(int start, int size) {
+    freeByAddress.erase(start);
+    freeBySize.erase({ size, start });
+    setLargestFree(start, 0);
+}
 
-    // Iterate through memory blocks and merge adjacent free blocks
-    for (size_t i = 0; i < memoryBlocks.size() - 1; ++i) {
-        if (memoryBlocks[i].isFree && memoryBlocks[i + 1].isFree) { // Check if current block and next block are free
-            if (memoryBlocks[i].start + memoryBlocks[i].size == memoryBlocks[i + 1].start) { // Check if blocks are contiguous (magkatabi)
-                memoryBlocks[i].size += memoryBlocks[i + 1].size; // Merge blocks by adding their sizes onto current block
-                memoryBlocks.erase(memoryBlocks.begin() + i + 1); // Erase next block
-                --i; // Check again in case there are multiple contiguous free blocks
-            }
-        }
+void FlatMemoryAllocator::setLargestFree(int start, int size) {
+    int node = treeLeaves + start;
+    largestFree[node] = size;
+    for (node /= 2; node >= 1; node /= 2) {
+        largestFree[node] = std::max(largestFree[2 * node], largestFree[2 * node + 1]);
     }
 }
 
 void FlatMemoryAllocator::displayMemory() {
+    std::vector<MemoryBlock> memoryBlocks;
+    for (const auto& entry : freeByAddress) {
+        memoryBlocks.push_back({ entry.first, entry.second, true });
+    }
+    for (const auto& entry : processMemoryMap) {
+        memoryBlocks.push_back(entry.second);
+    }
+
+    // Sort memory blocks by start address
+    std::sort(memoryBlocks.begin(), memoryBlocks.end(), [](const MemoryBlock& a, const MemoryBlock& b) {
+        return a.start < b.start;
+        });
+
     std::cout << "Memory Blocks:" << std::endl;
     for (const auto& block : memoryBlocks) {
         std::cout << "Start: " << block.start 
@@ -115,20 +196,14 @@ void FlatMemoryAllocator::displayMemory() {
 
 // Total Memory allocated (active + inacive)
 int FlatMemoryAllocator::getUsedMemory() {
-    int usedMemory = 0;
-    for (const auto& block : memoryBlocks) {
-        if (!block.isFree) {
-            usedMemory += block.size;
-        }
-    }
     return usedMemory;
 }
 
 int FlatMemoryAllocator::getInactiveMemory(const std::unordered_set<int>& runningProcessIDs) {
     int inactiveMemory = 0;
-    for (const auto& block : memoryBlocks) {
-        if (!block.isFree && runningProcessIDs.find(block.start) == runningProcessIDs.end()) {
-            inactiveMemory += block.size;
+    for (const auto& entry : processMemoryMap) {
+        if (runningProcessIDs.find(entry.first) == runningProcessIDs.end()) {
+            inactiveMemory += entry.second.size;
         }
     }
     return inactiveMemory;
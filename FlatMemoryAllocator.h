@@ -1,11 +1,16 @@
 #pragma once
 
 #include <vector>
+#include <map>
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <memory>
+#include <functional>
 
 #include "Process.h"
 #include "ConfigurationManager.h"
+#include "ReplacementPolicy.h"
 
 // MemoryBlock struct (for flat alloc)
 struct MemoryBlock {
@@ -17,12 +22,17 @@ struct MemoryBlock {
 class FlatMemoryAllocator
 {
 public:
+	// Which free block an allocation is carved from
+	enum class FitPolicy { FIRST_FIT, BEST_FIT, WORST_FIT, NEXT_FIT };
+
 	FlatMemoryAllocator();
 
 	void initialize(ConfigurationManager* configManager); // initialize memory blocks
-	bool allocate(Process process);	// allocate memory for a process
+	bool allocate(const Process& process);	// allocate memory for a process
 	void deallocate(int pid);
-	int swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs); // swap out a random process
+	int swapOutVictimProcess(const ReplacementPolicy::SlotFilter& claimVictim); // swap out the process the replacement policy picks, claimVictim is asked only about the one it is about to take
+	void setReferenceSource(std::function<bool(int pid)> source); // Tests and clears a process's reference bit
+	void tickReplacement(); // Periodic reference sampling for aging policies
 	void displayMemory();
 
 	int getUsedMemory(); // returns active + idle processes 
@@ -30,10 +40,25 @@ public:
 	
 private:
 	ConfigurationManager* configManager;
-	std::vector<MemoryBlock> memoryBlocks; // memory blocks
-	std::unordered_map<int, int> processMemoryMap; // memory block index
+	std::unique_ptr<ReplacementPolicy> replacementPolicy; // Slots are PIDs, whole processes are evicted
+	std::function<bool(int pid)> referenceSource;
+	FitPolicy policy;
 	int memorySize;	// total memory size
+	int usedMemory;
 
-	void mergeFreeBlocks(); // merge adjacent free blocks
-};
+	// Free blocks are indexed three ways, all kept in sync by addFreeBlock and removeFreeBlock
+	std::map<int, int> freeByAddress; // start -> size, neighbours for coalescing
+	std::set<std::pair<int, int>> freeBySize; // (size, start), best-fit and worst-fit
+	std::vector<int> largestFree; // Max segment tree over addresses, leaf = size of the free block starting there, first-fit and next-fit
+	int treeLeaves; // Leaf count, memorySize rounded up to a power of two
+	int nextFitStart; // Address the next next-fit search starts from
 
+	std::unordered_map<int, MemoryBlock> processMemoryMap; // pid -> allocated block
+
+	int findFreeBlock(int size); // Start of the free block the policy picks, -1 if none fits
+	int findFirstFit(int from, int size); // Lowest free block at or after from that fits, -1 if none
+	int findFirstFit(int node, int lo, int hi, int from, int size); // Same, within the subtree covering [lo, hi)
+	void addFreeBlock(int start, int size);
+	void removeFreeBlock(int start, int size);
+	void setLargestFree(int start, int size); // Update the segment tree leaf and its ancestors
+};
@@ -0,0 +1,110 @@
+#include "IndexedProcessQueue.h"
+
+IndexedProcessQueue::IndexedProcessQueue() {}
+
+void IndexedProcessQueue::push(std::shared_ptr<Process> process, int key) {
+    if (updateKey(process->getID(), key)) {
+        return; // Already queued, only the key changed
+    }
+
+    heap.push_back({ key, process });
+    positions[process->getID()] = heap.size() - 1;
+    siftUp(heap.size() - 1);
+}
+
+std::shared_ptr<Process> IndexedProcessQueue::pop() {
+    std::shared_ptr<Process> process = heap.front().process;
+
+    swapEntries(0, heap.size() - 1);
+    heap.pop_back();
+    positions.erase(process->getID());
+
+    if (!heap.empty()) {
+        siftDown(0);
+    }
+    return process;
+}
+
+const std::shared_ptr<Process>& IndexedProcessQueue::top() const {
+    return heap.front().process;
+}
+
+int IndexedProcessQueue::topKey() const {
+    return heap.front().key;
+}
+
+bool IndexedProcessQueue::contains(int pid) const {
+    return positions.find(pid) != positions.end();
+}
+
+bool IndexedProcessQueue::updateKey(int pid, int key) {
+    auto it = positions.find(pid);
+    if (it == positions.end()) {
+        return false;
+    }
+
+    size_t index = it->second;
+    int oldKey = heap[index].key;
+    heap[index].key = key;
+
+    if (key < oldKey) {
+        siftUp(index);
+    }
+    else if (key > oldKey) {
+        siftDown(index);
+    }
+    return true;
+}
+
+bool IndexedProcessQueue::empty() const {
+    return heap.empty();
+}
+
+size_t IndexedProcessQueue::size() const {
+    return heap.size();
+}
+
+bool IndexedProcessQueue::less(size_t a, size_t b) const {
+    if (heap[a].key != heap[b].key) {
+        return heap[a].key < heap[b].key;
+    }
+    return heap[a].process->getID() < heap[b].process->getID();
+}
+
+void IndexedProcessQueue::swapEntries(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    positions[heap[a].process->getID()] = a;
+    positions[heap[b].process->getID()] = b;
+}
+
+void IndexedProcessQueue::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!less(index, parent)) {
+            break;
+        }
+        swapEntries(index, parent);
+        index = parent;
+    }
+}
+
+void IndexedProcessQueue::siftDown(size_t index) {
+    while (true) {
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        size_t smallest = index;
+
+        if (left < heap.size() && less(left, smallest)) {
+            smallest = left;
+        }
+        if (right < heap.size() && less(right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+
+        swapEntries(index, smallest);
+        index = smallest;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "Process.h"
+
+// Binary min-heap of processes keyed by an instruction count, with a PID -> heap
+// position index so a process already in the queue can have its key changed in
+// O(log n) instead of being searched for. Not thread-safe, owned by the scheduler thread.
+class IndexedProcessQueue
+{
+public:
+    IndexedProcessQueue();
+
+    void push(std::shared_ptr<Process> process, int key); // Inserts the process, or updates its key if already queued
+    std::shared_ptr<Process> pop(); // Removes and returns the process with the smallest key
+    const std::shared_ptr<Process>& top() const; // Process with the smallest key
+    int topKey() const; // Key of the process with the smallest key
+
+    bool contains(int pid) const;
+    bool updateKey(int pid, int key); // Decrease or increase the key of a queued process, false if not queued
+    bool empty() const;
+    size_t size() const;
+
+private:
+    struct Entry {
+        int key;
+        std::shared_ptr<Process> process;
+    };
+
+    std::vector<Entry> heap;
+    std::unordered_map<int, size_t> positions; // PID -> index in heap
+
+    bool less(size_t a, size_t b) const; // Orders by key, then by PID so equal keys stay in arrival order
+    void swapEntries(size_t a, size_t b);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Opcodes of the process instruction set
+enum class Opcode : uint8_t
+{
+    PRINT,    // Log a message, or a variable's value if OPERAND_A_IS_VARIABLE is set
+    DECLARE,  // variables[dest] = a
+    ADD,      // variables[dest] = a + b, clamped to uint16
+    SUBTRACT, // variables[dest] = a - b, clamped to uint16
+    SLEEP,    // Give up the next a ticks without executing anything
+    FOR,      // Run the following body a times
+    END_FOR   // Close the innermost FOR, a is the body length
+};
+
+// One bytecode instruction, packed into 8 bytes so a program stays cache-friendly
+struct Instruction
+{
+    static const uint8_t OPERAND_A_IS_VARIABLE = 1 << 0; // Otherwise a is an immediate
+    static const uint8_t OPERAND_B_IS_VARIABLE = 1 << 1; // Otherwise b is an immediate
+
+    Opcode opcode = Opcode::PRINT;
+    uint8_t flags = 0;
+    uint16_t dest = 0; // Destination variable index
+    uint16_t a = 0;
+    uint16_t b = 0;
+};
@@ -0,0 +1,110 @@
+#include "InstructionGenerator.h"
+
+#include <algorithm>
+
+const int InstructionGenerator::MAX_LOOP_BODY; // Bound by reference in std::min
+
+InstructionGenerator::InstructionGenerator() : rngState(1), remainingBudget(0) {}
+
+InstructionGenerator::InstructionGenerator(int totalInstructions, uint32_t seed) : remainingBudget(totalInstructions) {
+    // Spread consecutive seeds apart, xorshift needs a non-zero state
+    rngState = seed * 2654435761u ^ 0x9E3779B9u;
+    if (rngState == 0) {
+        rngState = 1;
+    }
+}
+
+bool InstructionGenerator::nextChunk(std::vector<Instruction>& chunk) {
+    chunk.clear();
+    while (remainingBudget > 0 && chunk.size() < CHUNK_SIZE) {
+        remainingBudget -= generateItem(chunk, remainingBudget, 0);
+    }
+    return !chunk.empty();
+}
+
+bool InstructionGenerator::isExhausted() const {
+    return remainingBudget <= 0;
+}
+
+uint32_t InstructionGenerator::nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+int InstructionGenerator::generateItem(std::vector<Instruction>& program, int budget, int depth) {
+    // A FOR costs its header once plus (body + END_FOR) per iteration
+    if (depth < MAX_LOOP_DEPTH && budget >= 5 && nextRandom() % 8 == 0) {
+        int repeats = 2 + nextRandom() % 3;
+        int maxBody = std::min((budget - 1) / repeats - 1, MAX_LOOP_BODY);
+        if (maxBody >= 1) {
+            int body = 1 + nextRandom() % maxBody;
+
+            Instruction loop;
+            loop.opcode = Opcode::FOR;
+            loop.a = static_cast<uint16_t>(repeats);
+            program.push_back(loop);
+
+            size_t bodyStart = program.size();
+            generateBlock(program, body, depth + 1);
+
+            Instruction end;
+            end.opcode = Opcode::END_FOR;
+            end.a = static_cast<uint16_t>(program.size() - bodyStart);
+            program.push_back(end);
+
+            return 1 + repeats * (body + 1);
+        }
+    }
+
+    program.push_back(randomInstruction());
+    return 1;
+}
+
+void InstructionGenerator::generateBlock(std::vector<Instruction>& program, int budget, int depth) {
+    while (budget > 0) {
+        budget -= generateItem(program, budget, depth);
+    }
+}
+
+Instruction InstructionGenerator::randomInstruction() {
+    Instruction instruction;
+    instruction.dest = static_cast<uint16_t>(nextRandom() % NUM_VARIABLES);
+
+    // Mostly arithmetic so a program is CPU-bound, with the occasional print or sleep
+    switch (nextRandom() % 8) {
+    case 0:
+        instruction.opcode = Opcode::PRINT;
+        if (nextRandom() % 2) {
+            instruction.flags = Instruction::OPERAND_A_IS_VARIABLE;
+            instruction.a = static_cast<uint16_t>(nextRandom() % NUM_VARIABLES);
+        }
+        break;
+    case 1:
+        instruction.opcode = Opcode::DECLARE;
+        instruction.a = static_cast<uint16_t>(nextRandom() % 100);
+        break;
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+    case 6:
+        instruction.opcode = nextRandom() % 2 ? Opcode::ADD : Opcode::SUBTRACT;
+        instruction.flags = Instruction::OPERAND_A_IS_VARIABLE;
+        instruction.a = static_cast<uint16_t>(nextRandom() % NUM_VARIABLES);
+        if (nextRandom() % 2) {
+            instruction.flags |= Instruction::OPERAND_B_IS_VARIABLE;
+            instruction.b = static_cast<uint16_t>(nextRandom() % NUM_VARIABLES);
+        }
+        else {
+            instruction.b = static_cast<uint16_t>(nextRandom() % 100);
+        }
+        break;
+    default:
+        instruction.opcode = Opcode::SLEEP;
+        instruction.a = static_cast<uint16_t>(1 + nextRandom() % MAX_SLEEP_TICKS);
+        break;
+    }
+    return instruction;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Instruction.h"
+
+// Generates a process's program on demand from a seed, one chunk at a time, so a
+// process that has not run yet holds only the generator state and no instructions.
+// The executed instruction count, counting every loop iteration, is exactly the
+// requested total, and the same seed always yields the same program.
+class InstructionGenerator
+{
+public:
+    InstructionGenerator(); // Empty program
+    InstructionGenerator(int totalInstructions, uint32_t seed);
+
+    // Replace chunk with the next CHUNK_SIZE or so instructions, false once the program is exhausted.
+    // Loops never straddle two chunks, so jumps stay within the chunk being executed.
+    bool nextChunk(std::vector<Instruction>& chunk);
+    bool isExhausted() const;
+
+    static const int CHUNK_SIZE = 64;
+    static const int NUM_VARIABLES = 32; // Variables each process may use
+    static const int MAX_LOOP_DEPTH = 3;
+    static const int MAX_LOOP_BODY = 8; // Executed instructions per iteration, bounds how far a chunk can overrun CHUNK_SIZE
+    static const int MAX_SLEEP_TICKS = 5;
+
+private:
+    uint32_t rngState; // xorshift32, small enough to keep per process
+    int remainingBudget; // Executed instructions not generated yet
+
+    uint32_t nextRandom();
+    int generateItem(std::vector<Instruction>& program, int budget, int depth); // Appends one instruction or loop, returns its executed cost
+    void generateBlock(std::vector<Instruction>& program, int budget, int depth); // Appends instructions costing exactly budget
+    Instruction randomInstruction();
+};
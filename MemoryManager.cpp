@@ -1,20 +1,18 @@
 #include <iostream>
 #include "MemoryManager.h"
 
-MemoryManager::MemoryManager() : running(false), backingStore("backing_store.txt") // Initialize running to false
+MemoryManager::MemoryManager() : clock(nullptr), backingStore("backing_store.txt"), running(false) // Initialize running to false
 {}
 
 MemoryManager::~MemoryManager() {
     stop();
-    if (memoryThread.joinable()) {
-        memoryThread.join();
-    }
 }
 
-bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* scheduler) {
+bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* scheduler, SimulationClock* clock) {
     try {
         this->configManager = configManager;
         this->scheduler = scheduler;
+        this->clock = clock;
         allocationType = configManager->getMemoryManagerAlgorithm();
 
         // Initialize the memory allocator based on the configuration
@@ -22,10 +20,42 @@ bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* s
             flatAllocator.initialize(configManager);
         }
         else if (allocationType == "paging") {
-            pagingAllocator.initialize(configManager);
+            pagingAllocator.initialize(configManager, &backingStore);
+        }
+        else if (allocationType == "buddy") {
+            buddyAllocator.initialize(configManager);
+        }
+
+        // Whole-process allocators read the reference bit the cores set on each process, paging keeps one per page
+        auto referenceSource = [this](int pid) {
+            auto process = this->scheduler->getProcessByID(pid);
+            return process && process->testAndClearReferenced();
+            };
+        flatAllocator.setReferenceSource(referenceSource);
+        buddyAllocator.setReferenceSource(referenceSource);
+
+        // Whole processes are swapped back in when a core is handed one that was evicted, and every
+        // allocator takes hints to bring in the processes the Scheduler is about to dispatch
+        scheduler->setSwapInHandler(
+            allocationType == "paging" ? nullptr : std::function<void(std::shared_ptr<Process>)>([this](std::shared_ptr<Process> process) { raisePageFault(process); }),
+            [this](std::shared_ptr<Process> process) { prefetchProcess(process); });
+
+        // Paging loads pages on demand, the cores fault on the first touch of each page
+        if (allocationType == "paging") {
+            scheduler->setPageFaultHandler(
+                [this](const Process& process, TLB& tlb) { return walkPageTable(process, tlb); },
+                [this](std::shared_ptr<Process> process) { raisePageFault(process); },
+                [this](int pid, int page) { markPageDirty(pid, page); });
+            pagingAllocator.setShootdownListener([this](int pid, int page) {
+                this->scheduler->invalidateTLBEntry(pid, page);
+                });
         }
 
+        lowWatermark = configManager->getMaxOverallMemory() * configManager->getReclaimLowWatermark() / 100;
+        highWatermark = configManager->getMaxOverallMemory() * configManager->getReclaimHighWatermark() / 100;
+
         running = true;
+        clock->addParticipant(clockParticipant);
         memoryThread = std::thread(&MemoryManager::run, this); // Start the memory manager thread
         return true;
     }
@@ -35,75 +65,383 @@ bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* s
     }
 }
 
-bool MemoryManager::allocate(Process process) {
+bool MemoryManager::allocate(const Process& process) {
+    bool allocated;
+    bool wakeReclaim = false;
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+
+        if (allocationType == "paging") {
+            // Only the page table is set up, pages are brought in as the process faults on them
+            return pagingAllocator.allocate(process);
+        }
+
+        // The background reclaimer normally keeps enough free that this does not evict
+        int swapFaultsBefore = numSwapFaults;
+        allocated = allocateProcess(process, getProtectedProcessIDs(), true);
+        if (numSwapFaults != swapFaultsBefore) {
+            numDirectReclaims++;
+        }
+
+        if (!reclaimRequested && getFreeMemoryLocked() < lowWatermark) {
+            reclaimRequested = true;
+            wakeReclaim = true;
+        }
+    }
+
+    if (wakeReclaim) {
+        clock->wake(clockParticipant);
+        faultRaised.notify_one();
+    }
+    return allocated;
+}
+
+bool MemoryManager::allocateProcess(const Process& process, const std::unordered_set<int>& protectedIDs, bool mayEvict) {
     if (allocationType == "flat") {
-        if (!flatAllocator.allocate(process)) {
-            // If allocation fails, swap out a random process and try again
-            std::unordered_set<int> runningProcessIDs = getRunningProcessIDs();
-            int swappedOutProcessID = flatAllocator.swapOutRandomProcess(runningProcessIDs);
-
-            if (swappedOutProcessID != -1) {
-                auto swappedOutProcess = scheduler->getProcessByID(swappedOutProcessID);
-                if (swappedOutProcess) {
-                    backingStore.storeProcess(swappedOutProcess);
-                }
+        if (flatAllocator.allocate(process)) {
+            return true;
+        }
+        if (!mayEvict) {
+            return false;
+        }
+
+        // If allocation fails, swap out the replacement policy's victim and try again
+        int swappedOutProcessID = flatAllocator.swapOutVictimProcess(claimVictim(protectedIDs));
+        if (swappedOutProcessID == -1) {
+            return false; // Everything resident is protected, a deferred swap-in retries on the tick
+        }
+        numSwapFaults++;
+        swapOutProcess(swappedOutProcessID);
+        return flatAllocator.allocate(process);
+    }
+    else if (allocationType == "buddy") {
+        // A single eviction may leave a hole whose buddy is still taken, keep evicting until the block fits
+        bool evicted = false;
+        while (!buddyAllocator.allocate(process)) {
+            if (!mayEvict) {
+                return false;
+            }
+            int swappedOutProcessID = buddyAllocator.swapOutVictimProcess(claimVictim(protectedIDs));
+            if (swappedOutProcessID == -1) {
+                return false;
             }
+            if (!evicted) {
+                numSwapFaults++;
+                evicted = true;
+            }
+            swapOutProcess(swappedOutProcessID);
+        }
+        return true;
+    }
+    return false;
+}
 
-            return flatAllocator.allocate(process);
+ReplacementPolicy::SlotFilter MemoryManager::claimVictim(const std::unordered_set<int>& protectedIDs) {
+    // Only a process waiting in a queue is taken, and it is moved to SWAPPED before its memory is freed, so a
+    // process that is new, on a core, or dispatched since protectedIDs was taken keeps its memory. A finished
+    // process just gives its memory back.
+    return [this, &protectedIDs](int pid) {
+        if (protectedIDs.find(pid) != protectedIDs.end()) {
+            return false;
         }
-        else {
-            return true;
+        auto process = scheduler->getProcessByID(pid);
+        return !process || process->isFinished() || process->transition(Process::State::READY, Process::State::SWAPPED);
+        };
+}
+
+void MemoryManager::swapOutProcess(int pid) {
+    if (pid == -1) {
+        return;
+    }
+
+    // claimVictim already moved it to SWAPPED, a core may have picked it up and blocked on it since
+    auto swappedOutProcess = scheduler->getProcessByID(pid);
+    if (swappedOutProcess && !swappedOutProcess->isFinished()) {
+        backingStore.storeProcess(swappedOutProcess);
+        swappedOutProcesses.insert(pid);
+    }
+}
+
+bool MemoryManager::swapInProcess(const std::shared_ptr<Process>& process, const std::unordered_set<int>& protectedIDs, bool mayEvict) {
+    int pid = process->getID();
+    if (swappedOutProcesses.find(pid) == swappedOutProcesses.end()) {
+        return true; // A prefetch brought it in while the fault was pending
+    }
+    if (!allocateProcess(*process, protectedIDs, mayEvict)) {
+        return false;
+    }
+
+    // The whole image is read back in one go, the process is its own read-ahead cluster
+    backingStore.loadProcess(pid);
+    backingStore.removeProcess(pid);
+    swappedOutProcesses.erase(pid);
+    numSwapIns++;
+    return true;
+}
+
+void MemoryManager::deallocate(int pid) {
+    bool retryFaults;
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+        pendingPrefetches.erase(pid); // The caller is about to release the process's slot
+        pinnedProcesses.erase(pid);
+        if (swappedOutProcesses.erase(pid)) {
+            backingStore.removeProcess(pid);
         }
+
+        if (allocationType == "flat") {
+            flatAllocator.deallocate(pid);
+        }
+        else if (allocationType == "paging") {
+            pagingAllocator.deallocate(pid);
+        }
+        else if (allocationType == "buddy") {
+            buddyAllocator.deallocate(pid);
+        }
+
+        // Faults that found no frame can be serviced now instead of at the next tick
+        retryFaults = !pendingFaults.empty();
+        faultsRaised = faultsRaised || retryFaults;
     }
-    else if (allocationType == "paging") {
-        if (!pagingAllocator.allocate(process, [this](std::shared_ptr<Process> process) {
-            this->backingStore.storeProcess(process);
-            })) {
-            // If allocation fails, swap out a random page and try again
-            std::unordered_set<int> runningProcessIDs = getRunningProcessIDs();
-            int swappedOutProcessID = pagingAllocator.swapOutRandomPage(runningProcessIDs, [this](std::shared_ptr<Process> process) {
-                this->backingStore.storeProcess(process);
-                });
 
-            if (swappedOutProcessID != -1) {
-                auto swappedOutProcess = scheduler->getProcessByID(swappedOutProcessID);
-                if (swappedOutProcess) {
-                    backingStore.storeProcess(swappedOutProcess);
-                }
+    if (retryFaults) {
+        clock->wake(clockParticipant);
+        faultRaised.notify_one();
+    }
+}
+
+void MemoryManager::stop() {
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+        running = false;
+    }
+    if (clock) {
+        clock->wake(clockParticipant); // Not set before initialize
+    }
+    faultRaised.notify_all();
+    if (memoryThread.joinable()) {
+        memoryThread.join();
+    }
+}
+
+void MemoryManager::run() {
+    const auto tickPeriod = std::chrono::milliseconds(100); // Adjust as needed
+    std::chrono::nanoseconds nextTick = clock->now();
+
+    std::unique_lock<std::mutex> lock(memoryMutex);
+    while (running) {
+        // Sample the reference bits so aging policies can tell recently used memory apart
+        bool ticked = clock->now() >= nextTick;
+        if (ticked) {
+            if (allocationType == "flat") {
+                flatAllocator.tickReplacement();
+            }
+            else if (allocationType == "paging") {
+                pagingAllocator.tickReplacement();
+            }
+            else if (allocationType == "buddy") {
+                buddyAllocator.tickReplacement();
+            }
+            nextTick = clock->now() + tickPeriod;
+        }
+
+        // New faults are serviced right away, faults that found no frame wait for the next tick
+        if (faultsRaised || (ticked && !pendingFaults.empty())) {
+            servicePageFaults(lock);
+        }
+
+        // Page-ins use up free memory too, so the watermark is checked on every pass and not only when allocate asks
+        if (reclaimRequested || getFreeMemoryLocked() < lowWatermark) {
+            reclaimRequested = reclaimBatch();
+            if (reclaimRequested) {
+                // Let the allocation thread and the cores in between batches
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+                continue;
             }
+        }
 
-            return pagingAllocator.allocate(process, [this](std::shared_ptr<Process> process) {
-                this->backingStore.storeProcess(process);
-            });
+        auto workArrived = [this] { return !running || faultsRaised || reclaimRequested; };
+        if (clock->isVirtual()) {
+            // A deadline would be an event of its own and move virtual time forward while everything else is idle,
+            // so the reference bits are sampled when the next fault, page-in or deallocation wakes the thread
+            clock->wait(clockParticipant, lock, faultRaised, workArrived);
         }
         else {
-            return true;
+            clock->waitUntil(clockParticipant, lock, faultRaised, nextTick, workArrived);
         }
     }
-    return false;
+    lock.unlock();
+
+    clock->removeParticipant(clockParticipant);
 }
 
-void MemoryManager::deallocate(int pid) {
+std::unordered_set<int> MemoryManager::getProtectedProcessIDs() {
+    // Memory of running processes is in use, and memory just brought in stays until its process has run
+    // on it, otherwise a long ready queue would evict everything before its owner is dispatched
+    std::unordered_set<int> protectedIDs = getRunningProcessIDs();
+    for (auto it = pinnedProcesses.begin(); it != pinnedProcesses.end();) {
+        auto process = scheduler->getProcessByID(it->first);
+        if (!process || process->isFinished() || process->getCurrentInstruction() != it->second) {
+            it = pinnedProcesses.erase(it);
+        }
+        else {
+            protectedIDs.insert(it->first);
+            ++it;
+        }
+    }
+    return protectedIDs;
+}
+
+void MemoryManager::servicePageFaults(std::unique_lock<std::mutex>& lock) {
+    faultsRaised = false;
+    std::unordered_set<int> protectedIDs = getProtectedProcessIDs();
+
+    std::vector<std::shared_ptr<Process>> resumed;
+    for (size_t i = pendingFaults.size(); i > 0; i--) {
+        std::shared_ptr<Process> process = pendingFaults.front();
+        pendingFaults.pop_front();
+
+        bool resident;
+        if (allocationType == "paging") {
+            if (!pagingAllocator.isAllocated(process->getID())) {
+                continue; // Deallocated while blocked, there is nothing left to run
+            }
+            resident = pagingAllocator.loadPage(process->getID(), process->getCurrentPage(), protectedIDs);
+        }
+        else {
+            resident = swapInProcess(process, protectedIDs, true);
+        }
+
+        if (!resident) {
+            pendingFaults.push_back(process); // All memory is protected, stay blocked until some frees up
+            continue;
+        }
+
+        pinnedProcesses[process->getID()] = process->getCurrentInstruction();
+        protectedIDs.insert(process->getID());
+        resumed.push_back(process);
+    }
+
+    // Hints go after the faults so they only take memory the blocked processes did not need
+    servicePrefetches();
+
+    // Requeue without the lock so the Scheduler is never entered while holding memoryMutex
+    lock.unlock();
+    for (auto& process : resumed) {
+        scheduler->resumeProcess(process);
+    }
+    lock.lock();
+}
+
+bool MemoryManager::walkPageTable(const Process& process, TLB& tlb) {
+    // The fill happens under memoryMutex so a concurrent eviction cannot shoot down the entry before it is cached.
+    // Like a hardware walker it sets the page's reference bit, TLB hits need not since clearing the bit shoots them down
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    int page = process.getCurrentPage();
+    if (!pagingAllocator.referencePage(process.getID(), page)) {
+        return false;
+    }
+    tlb.insert(process.getID(), page);
+    return true;
+}
+
+void MemoryManager::markPageDirty(int pid, int page) {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    pagingAllocator.markDirty(pid, page);
+}
+
+bool MemoryManager::reclaimBatch() {
+    // Cold memory goes first, the replacement policy skips whatever was referenced since it last looked
+    std::unordered_set<int> protectedIDs = getProtectedProcessIDs();
+    for (int i = 0; i < RECLAIM_BATCH; i++) {
+        if (getFreeMemoryLocked() >= highWatermark) {
+            return false;
+        }
+
+        int victimID = -1;
+        if (allocationType == "flat") {
+            victimID = flatAllocator.swapOutVictimProcess(claimVictim(protectedIDs));
+            swapOutProcess(victimID);
+        }
+        else if (allocationType == "paging") {
+            victimID = pagingAllocator.swapOutVictimPage(protectedIDs);
+        }
+        else if (allocationType == "buddy") {
+            victimID = buddyAllocator.swapOutVictimProcess(claimVictim(protectedIDs));
+            swapOutProcess(victimID);
+        }
+
+        if (victimID == -1) {
+            return false; // Everything left is protected, the next allocation or page-in tries again
+        }
+        numBackgroundEvictions++;
+    }
+    return getFreeMemoryLocked() < highWatermark;
+}
+
+int MemoryManager::getFreeMemoryLocked() {
+    int usedMemory = 0;
     if (allocationType == "flat") {
-        flatAllocator.deallocate(pid);
+        usedMemory = flatAllocator.getUsedMemory();
     }
     else if (allocationType == "paging") {
-        pagingAllocator.deallocate(pid);
+        usedMemory = pagingAllocator.getUsedMemory();
     }
+    else if (allocationType == "buddy") {
+        usedMemory = buddyAllocator.getUsedMemory();
+    }
+    return configManager->getMaxOverallMemory() - usedMemory;
 }
 
-void MemoryManager::stop() {
-    running = false;
+void MemoryManager::servicePrefetches() {
+    for (auto& hint : pendingPrefetches) {
+        const std::shared_ptr<Process>& process = hint.second;
+        // Hints only take memory above the low watermark, otherwise the reclaimer would evict what they bring in
+        int needed = allocationType == "paging" ? 0 : static_cast<int>(process->getMemorySize());
+        if (process->isFinished() || getFreeMemoryLocked() - needed < lowWatermark) {
+            continue;
+        }
+
+        if (allocationType == "paging") {
+            if (pagingAllocator.isAllocated(process->getID())) {
+                pagingAllocator.prefetchPage(process->getID(), process->getCurrentPage());
+            }
+        }
+        else if (process->getState() == Process::State::SWAPPED && swapInProcess(process, {}, false)) {
+            // Fails if a core blocked on the process meanwhile, its pending fault then finds it resident
+            process->transition(Process::State::SWAPPED, Process::State::READY);
+            pinnedProcesses[process->getID()] = process->getCurrentInstruction(); // Not reclaimed again before it runs
+            numPrefetchedSwapIns++;
+        }
+    }
+    pendingPrefetches.clear();
 }
 
-void MemoryManager::run() {
-    while (running) {
-        // Perform periodic memory management tasks
-        // For example: Check memory status, handle requests, etc.
+void MemoryManager::prefetchProcess(std::shared_ptr<Process> process) {
+    // A whole-process allocator only has work to do for a swapped out process
+    if (allocationType != "paging" && process->getState() != Process::State::SWAPPED) {
+        return;
+    }
 
-        // Here, we'll just simulate work with sleep
-        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Adjust as needed
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+        pendingPrefetches[process->getID()] = process;
+        faultsRaised = true;
     }
+    clock->wake(clockParticipant);
+    faultRaised.notify_one();
+}
+
+void MemoryManager::raisePageFault(std::shared_ptr<Process> process) {
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+        pendingFaults.push_back(process);
+        faultsRaised = true;
+    }
+    clock->wake(clockParticipant);
+    faultRaised.notify_one();
 }
 
 std::unordered_set<int> MemoryManager::getRunningProcessIDs() const {
@@ -133,31 +471,64 @@ int MemoryManager::getActiveMemory() {
 }
 
 int MemoryManager::getUsedMemory() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
     int totalActiveMemory = 0;
-    if (configManager->getSchedulerAlgorithm() == "flat") {
+    if (allocationType == "flat") {
         totalActiveMemory = flatAllocator.getUsedMemory();
     }
+    else if (allocationType == "buddy") {
+        totalActiveMemory = buddyAllocator.getUsedMemory();
+    }
     else {
-        std::vector<int> processIDs = pagingAllocator.getProcessKeys();
-        std::vector<std::shared_ptr<Process>> allocatedProcesses;
-
-        for (const auto& id : processIDs) {
-            std::shared_ptr<Process> temp = scheduler->getProcessByID(id);
-            allocatedProcesses.push_back(temp);
-        }
-
-        totalActiveMemory = pagingAllocator.getUsedMemory(allocatedProcesses);
+        totalActiveMemory = pagingAllocator.getUsedMemory();
     }
     return totalActiveMemory;
 }
 
 int MemoryManager::getInactiveMemory() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
     int totalInactiveMemory = 0;
-    if (configManager->getSchedulerAlgorithm() == "flat") {
+    if (allocationType == "flat") {
         totalInactiveMemory = flatAllocator.getInactiveMemory(getRunningProcessIDs());
     }
+    else if (allocationType == "buddy") {
+        totalInactiveMemory = buddyAllocator.getInactiveMemory(getRunningProcessIDs());
+    }
     else {
         totalInactiveMemory = pagingAllocator.getInactiveMemory(getRunningProcessIDs());
     }
     return totalInactiveMemory;
 }
+
+int MemoryManager::getNumPageFaults() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    if (allocationType == "paging") {
+        return pagingAllocator.getNumPageFaults();
+    }
+    return numSwapFaults;
+}
+
+size_t MemoryManager::getPageTableBytes() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    return pagingAllocator.getPageTableBytes();
+}
+
+std::vector<int> MemoryManager::getPagingStats() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    return { pagingAllocator.getNumPagesPagedIn(), pagingAllocator.getNumPagesPagedOut(), pagingAllocator.getNumPagesReadAhead(),
+        pagingAllocator.getNumDirtyPagesWritten(), pagingAllocator.getNumCleanPagesDropped() };
+}
+
+std::vector<int> MemoryManager::getSwapInStats() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    return { numSwapIns, numPrefetchedSwapIns };
+}
+
+std::vector<int> MemoryManager::getReclaimStats() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    return { numBackgroundEvictions, numDirectReclaims };
+}
+
+std::vector<int> MemoryManager::getWatermarks() {
+    return { lowWatermark, highWatermark };
+}
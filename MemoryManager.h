@@ -2,14 +2,20 @@
 
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
 #include <iostream>
 
 #include "ConfigurationManager.h"
 #include "Process.h"
 #include "FlatMemoryAllocator.h"
 #include "PagingAllocator.h"
+#include "BuddyAllocator.h"
 #include "Scheduler.h"
 #include "BackingStore.h"
+#include "SimulationClock.h"
 
 class MemoryManager
 {
@@ -18,30 +24,74 @@ public:
     ~MemoryManager();
     FlatMemoryAllocator flatAllocator;
     PagingAllocator pagingAllocator;
+    BuddyAllocator buddyAllocator;
 
-    bool initialize(ConfigurationManager* configManager, Scheduler* scheduler);
-    bool allocate(Process process);
-    void deallocate(int pid);
+    bool initialize(ConfigurationManager* configManager, Scheduler* scheduler, SimulationClock* clock);
+    bool allocate(const Process& process);
+    void deallocate(int pid); // Gives a finished process's memory back and drops every hint kept for it
 
-    void stop(); // Method to stop the thread
+    void stop(); // Method to stop the thread, returns once it has exited
     BackingStore* getBackingStore();
 
     // Get total active memory
     int getActiveMemory();
     int getUsedMemory();
     int getInactiveMemory();
+    int getNumPageFaults(); // Demand paging faults, or allocations that had to evict a process
+
+    // Demand paging, called by the cores
+    bool walkPageTable(const Process& process, TLB& tlb); // On a TLB miss, caches the translation if the page is resident
+    void raisePageFault(std::shared_ptr<Process> process); // Queue the page-in or swap-in, the process is requeued once it is resident
+    void prefetchProcess(std::shared_ptr<Process> process); // Scheduler hint for a process near the head of the queue, brought in only if memory is free
+    void markPageDirty(int pid, int page); // First write to a page since it was loaded
+    size_t getPageTableBytes();
+    std::vector<int> getPagingStats(); // Pages paged in, paged out and read ahead, dirty pages written back and clean pages dropped
+    std::vector<int> getSwapInStats(); // Processes swapped back in, and how many of those a prefetch hint brought in before dispatch
+    std::vector<int> getReclaimStats(); // Evictions by the background reclaimer, and allocations that still had to evict themselves
+    std::vector<int> getWatermarks(); // Low and high free memory watermarks in KB
 
 private:
     void run(); // Method that the thread will execute
 
     ConfigurationManager* configManager;
     Scheduler* scheduler;
+    SimulationClock* clock;
+    SimulationClock::Participant clockParticipant; // Counts the memory thread as busy while it services page faults
     BackingStore backingStore;
     
     std::string allocationType;
 
     std::thread memoryThread;
     std::atomic<bool> running;
+    std::mutex memoryMutex; // Serializes the allocation thread with the replacement ticks and the reporting reads
+    int numSwapFaults = 0; // Flat and buddy allocations that evicted a process, paging counts its own
+    std::deque<std::shared_ptr<Process>> pendingFaults; // Blocked processes waiting for a page or their image, guarded by memoryMutex
+    std::unordered_map<int, std::shared_ptr<Process>> pendingPrefetches; // PID -> hinted process, dropped if memory is full
+    bool faultsRaised = false; // New faults or hints since the last service pass, deferred faults are retried on the tick
+    std::condition_variable faultRaised; // Wakes the memory thread to service pendingFaults
+    std::unordered_map<int, int> pinnedProcesses; // PID -> instructions executed when its page came in, not evicted until it runs
+    std::unordered_set<int> swappedOutProcesses; // Flat and buddy processes whose image is in the backing store
+    int numSwapIns = 0;
+    int numPrefetchedSwapIns = 0;
+
+    // Background reclaim, kswapd-style: once free memory drops below the low watermark the memory thread
+    // evicts cold memory in batches until the high watermark is free again, ahead of the allocations
+    static const int RECLAIM_BATCH = 8; // Evictions per pass before the lock is handed back
+    int lowWatermark = 0; // KB
+    int highWatermark = 0;
+    bool reclaimRequested = false; // Set below the low watermark, cleared once the high one is reached or nothing is evictable
+    int numBackgroundEvictions = 0;
+    int numDirectReclaims = 0; // Allocations on the allocation thread that found too little free memory and evicted
+
+    void servicePageFaults(std::unique_lock<std::mutex>& lock); // Bring in the faulted pages and requeue their processes
+    void servicePrefetches(); // Bring hinted processes in while memory is free, never evicts
+    bool reclaimBatch(); // Evict up to RECLAIM_BATCH victims, true if still below the high watermark
+    int getFreeMemoryLocked(); // Called with memoryMutex held
+    bool allocateProcess(const Process& process, const std::unordered_set<int>& protectedIDs, bool mayEvict); // Flat and buddy, evicting unprotected processes if allowed
+    ReplacementPolicy::SlotFilter claimVictim(const std::unordered_set<int>& protectedIDs); // Flat and buddy victim filter, moves an accepted READY process to SWAPPED
+    void swapOutProcess(int pid); // Write an evicted process to the backing store, -1 is ignored
+    bool swapInProcess(const std::shared_ptr<Process>& process, const std::unordered_set<int>& protectedIDs, bool mayEvict); // True once the process is resident
+    std::unordered_set<int> getProtectedProcessIDs(); // Running processes and the ones just brought in that have not run yet
 
     std::unordered_set<int> getRunningProcessIDs() const; // get running process IDs
 
@@ -0,0 +1,381 @@
+#include "PageTable.h"
+
+#include <algorithm>
+
+std::unique_ptr<PageTable> PageTable::create(const std::string& name, int numFrames) {
+    if (name == "flat") {
+        return std::unique_ptr<PageTable>(new FlatPageTable());
+    }
+    if (name == "two-level") {
+        return std::unique_ptr<PageTable>(new TwoLevelPageTable());
+    }
+    if (name == "inverted") {
+        return std::unique_ptr<PageTable>(new InvertedPageTable(numFrames));
+    }
+    return nullptr;
+}
+
+// Flat
+
+void FlatPageTable::addProcess(int pid, int numPages) {
+    tables[pid].assign(numPages, PageTableEntry());
+}
+
+void FlatPageTable::removeProcess(int pid) {
+    tables.erase(pid);
+}
+
+bool FlatPageTable::contains(int pid) const {
+    return tables.find(pid) != tables.end();
+}
+
+int FlatPageTable::getNumPages(int pid) const {
+    auto it = tables.find(pid);
+    return it != tables.end() ? static_cast<int>(it->second.size()) : 0;
+}
+
+std::vector<int> FlatPageTable::getProcessIDs() const {
+    std::vector<int> processIDs;
+    for (const auto& table : tables) {
+        processIDs.push_back(table.first);
+    }
+    return processIDs;
+}
+
+PageTableEntry FlatPageTable::get(int pid, int page) const {
+    auto it = tables.find(pid);
+    if (it == tables.end() || page < 0 || page >= static_cast<int>(it->second.size())) {
+        return PageTableEntry();
+    }
+    return it->second[page];
+}
+
+void FlatPageTable::set(int pid, int page, PageTableEntry entry) {
+    auto it = tables.find(pid);
+    if (it != tables.end() && page >= 0 && page < static_cast<int>(it->second.size())) {
+        it->second[page] = entry;
+    }
+}
+
+void FlatPageTable::forEachEntry(int pid, const PageVisitor& visit) {
+    auto it = tables.find(pid);
+    if (it == tables.end()) {
+        return;
+    }
+    for (size_t page = 0; page < it->second.size(); page++) {
+        if (it->second[page].bits != 0) {
+            visit(static_cast<int>(page), it->second[page]);
+        }
+    }
+}
+
+void FlatPageTable::forEachResident(int pid, const PageVisitor& visit) {
+    auto it = tables.find(pid);
+    if (it == tables.end()) {
+        return;
+    }
+    for (size_t page = 0; page < it->second.size(); page++) {
+        if (it->second[page].has(PageTableEntry::PRESENT)) {
+            visit(static_cast<int>(page), it->second[page]);
+        }
+    }
+}
+
+size_t FlatPageTable::getMemoryBytes() const {
+    size_t bytes = 0;
+    for (const auto& table : tables) {
+        bytes += table.second.size() * sizeof(PageTableEntry);
+    }
+    return bytes;
+}
+
+// Two-level
+
+const int TwoLevelPageTable::SECOND_LEVEL_BITS;
+const int TwoLevelPageTable::SECOND_LEVEL_SIZE;
+
+void TwoLevelPageTable::addProcess(int pid, int numPages) {
+    removeProcess(pid);
+    Directory& directory = directories[pid];
+    directory.numPages = numPages;
+    directory.tables.resize((numPages + SECOND_LEVEL_SIZE - 1) >> SECOND_LEVEL_BITS);
+}
+
+void TwoLevelPageTable::removeProcess(int pid) {
+    auto it = directories.find(pid);
+    if (it == directories.end()) {
+        return;
+    }
+    for (const auto& table : it->second.tables) {
+        if (table) {
+            allocatedTables--;
+        }
+    }
+    directories.erase(it);
+}
+
+bool TwoLevelPageTable::contains(int pid) const {
+    return directories.find(pid) != directories.end();
+}
+
+int TwoLevelPageTable::getNumPages(int pid) const {
+    auto it = directories.find(pid);
+    return it != directories.end() ? it->second.numPages : 0;
+}
+
+std::vector<int> TwoLevelPageTable::getProcessIDs() const {
+    std::vector<int> processIDs;
+    for (const auto& directory : directories) {
+        processIDs.push_back(directory.first);
+    }
+    return processIDs;
+}
+
+PageTableEntry TwoLevelPageTable::get(int pid, int page) const {
+    auto it = directories.find(pid);
+    if (it == directories.end() || page < 0 || page >= it->second.numPages) {
+        return PageTableEntry();
+    }
+    const auto& table = it->second.tables[page >> SECOND_LEVEL_BITS];
+    return table ? table[page & (SECOND_LEVEL_SIZE - 1)] : PageTableEntry();
+}
+
+void TwoLevelPageTable::set(int pid, int page, PageTableEntry entry) {
+    auto it = directories.find(pid);
+    if (it == directories.end() || page < 0 || page >= it->second.numPages) {
+        return;
+    }
+
+    auto& table = it->second.tables[page >> SECOND_LEVEL_BITS];
+    if (!table) {
+        if (entry.bits == 0) {
+            return; // Still empty, no need for a table
+        }
+        table = std::make_unique<PageTableEntry[]>(SECOND_LEVEL_SIZE);
+        allocatedTables++;
+    }
+    table[page & (SECOND_LEVEL_SIZE - 1)] = entry;
+}
+
+void TwoLevelPageTable::forEachEntry(int pid, const PageVisitor& visitor) {
+    visit(pid, visitor, false);
+}
+
+void TwoLevelPageTable::forEachResident(int pid, const PageVisitor& visitor) {
+    visit(pid, visitor, true);
+}
+
+void TwoLevelPageTable::visit(int pid, const PageVisitor& visitor, bool residentOnly) {
+    auto it = directories.find(pid);
+    if (it == directories.end()) {
+        return;
+    }
+
+    // Unallocated second-level tables hold nothing, skip their whole range
+    const Directory& directory = it->second;
+    for (size_t index = 0; index < directory.tables.size(); index++) {
+        if (!directory.tables[index]) {
+            continue;
+        }
+        int base = static_cast<int>(index) << SECOND_LEVEL_BITS;
+        int end = std::min(directory.numPages - base, SECOND_LEVEL_SIZE);
+        for (int offset = 0; offset < end; offset++) {
+            PageTableEntry& entry = directory.tables[index][offset];
+            if (residentOnly ? entry.has(PageTableEntry::PRESENT) : entry.bits != 0) {
+                visitor(base + offset, entry);
+            }
+        }
+    }
+}
+
+size_t TwoLevelPageTable::getMemoryBytes() const {
+    size_t bytes = allocatedTables * SECOND_LEVEL_SIZE * sizeof(PageTableEntry);
+    for (const auto& directory : directories) {
+        bytes += directory.second.tables.size() * sizeof(std::unique_ptr<PageTableEntry[]>);
+    }
+    return bytes;
+}
+
+// Inverted
+
+InvertedPageTable::InvertedPageTable(int numFrames) : frames(numFrames) {
+    // At least one bucket per frame keeps the chains short
+    uint32_t numBuckets = 1;
+    while (numBuckets < static_cast<uint32_t>(numFrames)) {
+        numBuckets <<= 1;
+    }
+    buckets.assign(numBuckets, -1);
+    bucketMask = numBuckets - 1;
+}
+
+void InvertedPageTable::addProcess(int pid, int numPages) {
+    removeProcess(pid);
+    processes[pid].numPages = numPages;
+}
+
+void InvertedPageTable::removeProcess(int pid) {
+    auto it = processes.find(pid);
+    if (it == processes.end()) {
+        return;
+    }
+    while (it->second.firstFrame != -1) {
+        unlinkFrame(it->second.firstFrame);
+    }
+    processes.erase(it);
+}
+
+bool InvertedPageTable::contains(int pid) const {
+    return processes.find(pid) != processes.end();
+}
+
+int InvertedPageTable::getNumPages(int pid) const {
+    auto it = processes.find(pid);
+    return it != processes.end() ? it->second.numPages : 0;
+}
+
+std::vector<int> InvertedPageTable::getProcessIDs() const {
+    std::vector<int> processIDs;
+    for (const auto& process : processes) {
+        processIDs.push_back(process.first);
+    }
+    return processIDs;
+}
+
+PageTableEntry InvertedPageTable::get(int pid, int page) const {
+    int frame = findFrame(pid, page);
+    if (frame != -1) {
+        return frames[frame].entry;
+    }
+
+    auto it = processes.find(pid);
+    if (it != processes.end()) {
+        auto offFrame = it->second.offFrame.find(page);
+        if (offFrame != it->second.offFrame.end()) {
+            return offFrame->second;
+        }
+    }
+    return PageTableEntry();
+}
+
+void InvertedPageTable::set(int pid, int page, PageTableEntry entry) {
+    auto it = processes.find(pid);
+    if (it == processes.end() || page < 0 || page >= it->second.numPages) {
+        return;
+    }
+
+    int current = findFrame(pid, page);
+    if (entry.has(PageTableEntry::PRESENT)) {
+        int frame = entry.getFrame();
+        if (current == frame) {
+            frames[frame].entry = entry;
+            return;
+        }
+        if (current != -1) {
+            unlinkFrame(current); // Moved to another frame
+        }
+        if (frames[frame].pid != -1) {
+            unlinkFrame(frame); // Stale owner, the allocator already reused the frame
+        }
+        it->second.offFrame.erase(page);
+        linkFrame(frame, pid, page, entry);
+        return;
+    }
+
+    // No longer resident, only keep what is left of the entry (such as the swap slot)
+    if (current != -1) {
+        unlinkFrame(current);
+    }
+    if (entry.bits != 0) {
+        it->second.offFrame[page] = entry;
+    }
+    else {
+        it->second.offFrame.erase(page);
+    }
+}
+
+void InvertedPageTable::forEachEntry(int pid, const PageVisitor& visit) {
+    forEachResident(pid, visit);
+
+    auto it = processes.find(pid);
+    if (it != processes.end()) {
+        for (auto& offFrame : it->second.offFrame) {
+            visit(offFrame.first, offFrame.second);
+        }
+    }
+}
+
+void InvertedPageTable::forEachResident(int pid, const PageVisitor& visit) {
+    auto it = processes.find(pid);
+    if (it == processes.end()) {
+        return;
+    }
+    for (int frame = it->second.firstFrame; frame != -1; frame = frames[frame].ownerNext) {
+        visit(frames[frame].page, frames[frame].entry);
+    }
+}
+
+size_t InvertedPageTable::getMemoryBytes() const {
+    size_t bytes = frames.size() * sizeof(FrameEntry) + buckets.size() * sizeof(int);
+    for (const auto& process : processes) {
+        // Approximate hash node size: the key/value pair plus the next pointer
+        bytes += sizeof(ProcessInfo) + process.second.offFrame.size() * (sizeof(std::pair<const int, PageTableEntry>) + sizeof(void*));
+    }
+    return bytes;
+}
+
+size_t InvertedPageTable::bucketOf(int pid, int page) const {
+    uint32_t hash = static_cast<uint32_t>(pid) * 0x9E3779B1u ^ static_cast<uint32_t>(page) * 0x85EBCA6Bu;
+    hash ^= hash >> 16;
+    return hash & bucketMask;
+}
+
+int InvertedPageTable::findFrame(int pid, int page) const {
+    for (int frame = buckets[bucketOf(pid, page)]; frame != -1; frame = frames[frame].hashNext) {
+        if (frames[frame].pid == pid && frames[frame].page == page) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+void InvertedPageTable::linkFrame(int frame, int pid, int page, PageTableEntry entry) {
+    FrameEntry& slot = frames[frame];
+    slot.pid = pid;
+    slot.page = page;
+    slot.entry = entry;
+
+    size_t bucket = bucketOf(pid, page);
+    slot.hashNext = buckets[bucket];
+    buckets[bucket] = frame;
+
+    ProcessInfo& owner = processes[pid];
+    slot.ownerPrev = -1;
+    slot.ownerNext = owner.firstFrame;
+    if (owner.firstFrame != -1) {
+        frames[owner.firstFrame].ownerPrev = frame;
+    }
+    owner.firstFrame = frame;
+}
+
+void InvertedPageTable::unlinkFrame(int frame) {
+    FrameEntry& slot = frames[frame];
+
+    // Walk the bucket to the link that points at this frame
+    int* link = &buckets[bucketOf(slot.pid, slot.page)];
+    while (*link != frame) {
+        link = &frames[*link].hashNext;
+    }
+    *link = slot.hashNext;
+
+    if (slot.ownerPrev != -1) {
+        frames[slot.ownerPrev].ownerNext = slot.ownerNext;
+    }
+    else {
+        processes[slot.pid].firstFrame = slot.ownerNext;
+    }
+    if (slot.ownerNext != -1) {
+        frames[slot.ownerNext].ownerPrev = slot.ownerPrev;
+    }
+
+    slot = FrameEntry();
+}
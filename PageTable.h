@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+#include "PageTableEntry.h"
+
+// Maps (process, virtual page) to its PageTableEntry for the PagingAllocator.
+// Entries are read and written by value so each layout can store them its own
+// way; a page nobody has written reads back as an empty entry. The layouts
+// trade lookup cost against metadata size:
+//   flat       one contiguous array per process, sized by its address space
+//   two-level  a directory per process, second-level tables allocated on first use
+//   inverted   one entry per physical frame behind a hash, plus the swap slots of
+//              evicted pages, so resident metadata is bounded by physical memory
+class PageTable
+{
+public:
+    using PageVisitor = std::function<void(int page, PageTableEntry& entry)>;
+
+    virtual ~PageTable() {}
+
+    virtual const char* getName() const = 0;
+    virtual void addProcess(int pid, int numPages) = 0;
+    virtual void removeProcess(int pid) = 0;
+    virtual bool contains(int pid) const = 0;
+    virtual int getNumPages(int pid) const = 0; // 0 if the process has no table
+    virtual std::vector<int> getProcessIDs() const = 0;
+
+    virtual PageTableEntry get(int pid, int page) const = 0;
+    virtual void set(int pid, int page, PageTableEntry entry) = 0;
+
+    // Visit every page of a process that has any state. Flags other than PRESENT may be changed in place
+    virtual void forEachEntry(int pid, const PageVisitor& visit) = 0;
+    virtual void forEachResident(int pid, const PageVisitor& visit) = 0; // Only the present pages
+
+    virtual size_t getMemoryBytes() const = 0; // Metadata footprint over every process
+
+    // "flat", "two-level" or "inverted", nullptr for anything else
+    static std::unique_ptr<PageTable> create(const std::string& name, int numFrames);
+};
+
+class FlatPageTable : public PageTable
+{
+public:
+    const char* getName() const override { return "flat"; }
+    void addProcess(int pid, int numPages) override;
+    void removeProcess(int pid) override;
+    bool contains(int pid) const override;
+    int getNumPages(int pid) const override;
+    std::vector<int> getProcessIDs() const override;
+    PageTableEntry get(int pid, int page) const override;
+    void set(int pid, int page, PageTableEntry entry) override;
+    void forEachEntry(int pid, const PageVisitor& visit) override;
+    void forEachResident(int pid, const PageVisitor& visit) override;
+    size_t getMemoryBytes() const override;
+
+private:
+    std::unordered_map<int, std::vector<PageTableEntry>> tables; // One entry per virtual page
+};
+
+class TwoLevelPageTable : public PageTable
+{
+public:
+    static const int SECOND_LEVEL_BITS = 9; // 512 entries, 4 KB per second-level table
+    static const int SECOND_LEVEL_SIZE = 1 << SECOND_LEVEL_BITS;
+
+    const char* getName() const override { return "two-level"; }
+    void addProcess(int pid, int numPages) override;
+    void removeProcess(int pid) override;
+    bool contains(int pid) const override;
+    int getNumPages(int pid) const override;
+    std::vector<int> getProcessIDs() const override;
+    PageTableEntry get(int pid, int page) const override;
+    void set(int pid, int page, PageTableEntry entry) override;
+    void forEachEntry(int pid, const PageVisitor& visit) override;
+    void forEachResident(int pid, const PageVisitor& visit) override;
+    size_t getMemoryBytes() const override;
+
+private:
+    struct Directory {
+        int numPages = 0;
+        std::vector<std::unique_ptr<PageTableEntry[]>> tables; // nullptr until a page in its range is written
+    };
+
+    std::unordered_map<int, Directory> directories;
+    size_t allocatedTables = 0;
+
+    void visit(int pid, const PageVisitor& visit, bool residentOnly);
+};
+
+class InvertedPageTable : public PageTable
+{
+public:
+    explicit InvertedPageTable(int numFrames);
+
+    const char* getName() const override { return "inverted"; }
+    void addProcess(int pid, int numPages) override;
+    void removeProcess(int pid) override;
+    bool contains(int pid) const override;
+    int getNumPages(int pid) const override;
+    std::vector<int> getProcessIDs() const override;
+    PageTableEntry get(int pid, int page) const override;
+    void set(int pid, int page, PageTableEntry entry) override;
+    void forEachEntry(int pid, const PageVisitor& visit) override;
+    void forEachResident(int pid, const PageVisitor& visit) override;
+    size_t getMemoryBytes() const override;
+
+private:
+    struct FrameEntry {
+        int pid = -1; // -1 while the frame holds no page
+        int page = -1;
+        PageTableEntry entry;
+        int hashNext = -1; // Next frame in the same hash bucket
+        int ownerNext = -1; // Next frame of the same process
+        int ownerPrev = -1;
+    };
+
+    struct ProcessInfo {
+        int numPages = 0;
+        int firstFrame = -1; // Head of the process's resident frames
+        std::unordered_map<int, PageTableEntry> offFrame; // Pages that are not resident but still have state, such as a swap slot
+    };
+
+    std::vector<FrameEntry> frames; // Indexed by physical frame
+    std::vector<int> buckets; // Hash of (pid, page) -> first frame in the chain
+    uint32_t bucketMask;
+    std::unordered_map<int, ProcessInfo> processes;
+
+    size_t bucketOf(int pid, int page) const;
+    int findFrame(int pid, int page) const; // -1 if the page is not resident
+    void linkFrame(int frame, int pid, int page, PageTableEntry entry);
+    void unlinkFrame(int frame);
+};
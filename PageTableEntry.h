@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+// One virtual page of a process, packed into 8 bytes so a page table is a plain
+// contiguous array. The low bits are flags, then the frame the page occupies while
+// present, then the backing store slot holding its last written copy, if any.
+struct PageTableEntry
+{
+    static const uint64_t PRESENT = 1 << 0; // Loaded in the frame below
+    static const uint64_t DIRTY = 1 << 1; // Written since it was loaded, must be saved before eviction
+    static const uint64_t REFERENCED = 1 << 2; // Used since the replacement policy last looked
+    static const uint64_t IN_SWAP = 1 << 3; // The swap slot below holds a copy
+
+    static const int FIELD_BITS = 30; // Frame and swap slot each get 30 bits
+    static const int FRAME_SHIFT = 4;
+    static const int SLOT_SHIFT = FRAME_SHIFT + FIELD_BITS;
+    static const uint64_t FIELD_MASK = (uint64_t(1) << FIELD_BITS) - 1;
+
+    uint64_t bits = 0;
+
+    bool has(uint64_t flag) const { return (bits & flag) != 0; }
+    void set(uint64_t flag) { bits |= flag; }
+    void clear(uint64_t flag) { bits &= ~flag; }
+
+    int getFrame() const { return static_cast<int>((bits >> FRAME_SHIFT) & FIELD_MASK); }
+    void setFrame(int frame) { bits = (bits & ~(FIELD_MASK << FRAME_SHIFT)) | ((static_cast<uint64_t>(frame) & FIELD_MASK) << FRAME_SHIFT); }
+    int getSwapSlot() const { return static_cast<int>((bits >> SLOT_SHIFT) & FIELD_MASK); }
+    void setSwapSlot(int slot) { bits = (bits & ~(FIELD_MASK << SLOT_SHIFT)) | ((static_cast<uint64_t>(slot) & FIELD_MASK) << SLOT_SHIFT); }
+};
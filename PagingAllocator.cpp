@@ -3,146 +3,257 @@
 #include <algorithm>
 #include <ctime>
 
-PagingAllocator::PagingAllocator() {}
+PagingAllocator::PagingAllocator() : configManager(nullptr), backingStore(nullptr), memorySize(0), pageSize(0), numPagesPagedIn(0), numPagesPagedOut(0), numPageFaults(0), numDirtyPagesWritten(0), numCleanPagesDropped(0), numPagesReadAhead(0), readAheadPages(0) {}
 
-void PagingAllocator::initialize(ConfigurationManager* configManager) {
+void PagingAllocator::initialize(ConfigurationManager* configManager, BackingStore* backingStore) {
     this->configManager = configManager;
+    this->backingStore = backingStore;
 
     memorySize = configManager->getMaxOverallMemory();
     pageSize = configManager->getMinPagePerProcess(); // I dont think need?
+    readAheadPages = configManager->getSwapReadAhead();
     int numFrames = memorySize / pageSize;
-    memory.resize(numFrames, -1); // Initialize all frames as free
-}
-
-bool PagingAllocator::allocate(Process process, std::function<void(std::shared_ptr<Process>)> swapOutCallback) {
-    int pagesNeeded = pageSize;
-    std::vector<int> allocatedFrames;
-
-    while (pagesNeeded > 0) {
-        int freeFrame = findFreeFrame();
-        if (freeFrame == -1) {
-            // No free frame found, swap out a random page
-            std::unordered_set<int> runningProcessIDs; // Obtain this from the running processes
-            int swappedOutProcessID = swapOutRandomPage(runningProcessIDs, swapOutCallback);
-
-            if (swappedOutProcessID == -1) {
-                // Rollback if not enough pages were found
-                for (int frame : allocatedFrames) {
-                    memory[frame] = -1; // Mark the allocated pages as free
-                }
-                return false;
-            }
+    memory.assign(numFrames, -1); // Initialize all frames as free
+
+    freeFrameBitmap.assign((numFrames + 63) / 64, 0);
+    freeFrames.clear();
+    occupiedFrames.clear();
+    occupiedPosition.assign(numFrames, -1);
+    framePage.assign(numFrames, -1);
+    replacementPolicy = ReplacementPolicy::create(configManager->getPageReplacement());
+    pageTable = PageTable::create(configManager->getPageTable(), numFrames);
+    for (int frame = numFrames - 1; frame >= 0; --frame) {
+        freeFrameBitmap[frame / 64] |= uint64_t(1) << (frame % 64);
+        freeFrames.push_back(frame); // Pushed in reverse so low frames are handed out first
+    }
+}
+
+bool PagingAllocator::allocate(const Process& process) {
+    // Nothing is resident yet, the first instruction faults its page in
+    pageTable->addProcess(process.getID(), process.getNumPages());
+    return true;
+}
+
+bool PagingAllocator::isAllocated(int pid) const {
+    return pageTable->contains(pid);
+}
+
+bool PagingAllocator::isPageResident(int pid, int page) const {
+    return pageTable->get(pid, page).has(PageTableEntry::PRESENT);
+}
+
+bool PagingAllocator::referencePage(int pid, int page) {
+    PageTableEntry entry = pageTable->get(pid, page);
+    if (!entry.has(PageTableEntry::PRESENT)) {
+        return false;
+    }
+    if (!entry.has(PageTableEntry::REFERENCED)) {
+        entry.set(PageTableEntry::REFERENCED);
+        pageTable->set(pid, page, entry);
+    }
+    return true;
+}
+
+bool PagingAllocator::loadPage(int pid, int page, const std::unordered_set<int>& protectedProcessIDs) {
+    if (page >= pageTable->getNumPages(pid)) {
+        return false; // Deallocated while the fault was pending
+    }
+    if (pageTable->get(pid, page).has(PageTableEntry::PRESENT)) {
+        return true; // Already brought in by an earlier fault
+    }
+
+    int freeFrame = findFreeFrame();
+    if (freeFrame == -1) {
+        if (swapOutVictimPage(protectedProcessIDs) == -1) {
+            return false;
         }
-        else {
-            memory[freeFrame] = process.getID();
-            allocatedFrames.push_back(freeFrame);
-            ++numPagesPagedIn; // Increment the counter for pages paged in
-            --pagesNeeded;
+        freeFrame = findFreeFrame();
+    }
+
+    mapPage(pid, page, freeFrame, true); // About to be used, do not make it the next victim
+    ++numPageFaults;
+
+    // Instructions run through the pages in order, so the next ones are read in the same pass while frames are free
+    int lastPage = std::min(page + readAheadPages, pageTable->getNumPages(pid) - 1);
+    for (int next = page + 1; next <= lastPage; next++) {
+        if (!pageTable->get(pid, next).has(PageTableEntry::PRESENT) && !prefetchPage(pid, next)) {
+            break; // Out of free frames, read-ahead never evicts
         }
     }
+    return true;
+}
+
+bool PagingAllocator::prefetchPage(int pid, int page) {
+    if (page >= pageTable->getNumPages(pid) || pageTable->get(pid, page).has(PageTableEntry::PRESENT)) {
+        return true;
+    }
+
+    int freeFrame = findFreeFrame();
+    if (freeFrame == -1) {
+        return false;
+    }
 
-    processPageTable[process.getID()] = allocatedFrames;
+    // Left unreferenced so a page that is never used is the first to go again
+    mapPage(pid, page, freeFrame, false);
+    ++numPagesReadAhead;
     return true;
 }
 
+void PagingAllocator::mapPage(int pid, int page, int frame, bool referenced) {
+    // A page with a swap copy is read back, one never written out is rebuilt from the program
+    PageTableEntry entry = pageTable->get(pid, page); // Read after the eviction, which may have been one of this process's pages
+    if (entry.has(PageTableEntry::IN_SWAP)) {
+        backingStore->readPage(entry.getSwapSlot());
+    }
 
+    memory[frame] = pid;
+    framePage[frame] = page;
+    entry.setFrame(frame);
+    entry.set(PageTableEntry::PRESENT);
+    if (referenced) {
+        entry.set(PageTableEntry::REFERENCED);
+    }
+    entry.clear(PageTableEntry::DIRTY); // Matches its swap copy, or has nothing worth saving yet
+    pageTable->set(pid, page, entry);
+    replacementPolicy->onInsert(frame);
+    ++numPagesPagedIn;
+}
+
+void PagingAllocator::markDirty(int pid, int page) {
+    PageTableEntry entry = pageTable->get(pid, page);
+    if (entry.has(PageTableEntry::PRESENT)) {
+        entry.set(PageTableEntry::DIRTY);
+        pageTable->set(pid, page, entry);
+    }
+}
 
 void PagingAllocator::deallocate(int pid) {
-    auto it = processPageTable.find(pid);
-    if (it != processPageTable.end()) {
-        for (int frame : it->second) {
-            memory[frame] = -1; // Free the frame
+    pageTable->forEachEntry(pid, [this](int /*page*/, PageTableEntry& entry) {
+        if (entry.has(PageTableEntry::PRESENT)) {
+            releaseFrame(entry.getFrame()); // Free the frame
         }
-        processPageTable.erase(it);
-    }
+        if (entry.has(PageTableEntry::IN_SWAP)) {
+            backingStore->freeSlot(entry.getSwapSlot());
+        }
+        });
+    pageTable->removeProcess(pid);
 }
 
 int PagingAllocator::findFreeFrame() {
-    for (int i = 0; i < memory.size(); ++i) {
-        if (memory[i] == -1) {
-            return i;
-        }
+    if (freeFrames.empty()) {
+        return -1; // No free frame found
     }
-    return -1; // No free frame found
+
+    int frame = freeFrames.back();
+    freeFrames.pop_back();
+    freeFrameBitmap[frame / 64] &= ~(uint64_t(1) << (frame % 64));
+
+    occupiedPosition[frame] = static_cast<int>(occupiedFrames.size());
+    occupiedFrames.push_back(frame);
+    return frame;
 }
 
-int PagingAllocator::swapOutRandomPage(const std::unordered_set<int>& runningProcessIDs, std::function<void(std::shared_ptr<Process>)> swapOutCallback) {
-    std::vector<int> swappableFrames;
-    for (int i = 0; i < memory.size(); ++i) {
-        if (memory[i] != -1 && runningProcessIDs.find(memory[i]) == runningProcessIDs.end()) {
-            swappableFrames.push_back(i);
-        }
+void PagingAllocator::releaseFrame(int frame) {
+    if (isFrameFree(frame)) {
+        return;
     }
 
-    if (swappableFrames.empty()) {
-        return -1;
-    }
+    memory[frame] = -1;
+    framePage[frame] = -1;
+    replacementPolicy->onRemove(frame);
+    freeFrameBitmap[frame / 64] |= uint64_t(1) << (frame % 64);
+    freeFrames.push_back(frame);
+
+    // Swap the last occupied frame into the hole so removal is O(1)
+    int position = occupiedPosition[frame];
+    int last = occupiedFrames.back();
+    occupiedFrames[position] = last;
+    occupiedPosition[last] = position;
+    occupiedFrames.pop_back();
+    occupiedPosition[frame] = -1;
+}
 
-    srand(static_cast<unsigned int>(time(nullptr)));
-    int frameToSwap = swappableFrames[rand() % swappableFrames.size()];
-    swapOutPage(frameToSwap, swapOutCallback);
-    return memory[frameToSwap];
+bool PagingAllocator::isFrameFree(int frame) const {
+    return (freeFrameBitmap[frame / 64] >> (frame % 64)) & 1;
 }
 
-// TODO: Fix the shit
-void PagingAllocator::swapOutPage(int frame, std::function<void(std::shared_ptr<Process>)> swapOutCallback) {
+bool PagingAllocator::testAndClearFrameReference(int frame) {
     int pid = memory[frame];
-    if (pid != -1) {
-        //std::cout << "Swapping out page of process " << pid << " from frame " << frame << std::endl;
-        memory[frame] = -1; // Mark frame as free
-        ++numPagesPagedOut;
-
-        auto it = processPageTable.find(pid);
-        if (it != processPageTable.end()) {
-            // Retrieve the process details from a suitable source
-            std::string processName = "Process" + std::to_string(pid); // Example process name
-            int totalInstructions = 1000; // Example total instructions
-            float memorySize = it->second.size() * pageSize; // Calculate memory size from the number of pages
-            float processPageSize = static_cast<float>(pageSize); // Ensure it's a float
-
-            auto swappedOutProcess = std::make_shared<Process>(processName, pid, totalInstructions, memorySize, processPageSize);
-
-            if (swapOutCallback) {
-                swapOutCallback(swappedOutProcess);
-            }
-
-            // Remove the page frame from the process's page table
-            processPageTable[pid].erase(std::remove(processPageTable[pid].begin(), processPageTable[pid].end(), frame), processPageTable[pid].end());
-
-            // If the process has no more pages, remove it from the page table
-            if (processPageTable[pid].empty()) {
-                processPageTable.erase(pid);
-            }
+    int page = framePage[frame];
+    PageTableEntry entry = pageTable->get(pid, page);
+    bool referenced = entry.has(PageTableEntry::REFERENCED);
+    if (referenced) {
+        entry.clear(PageTableEntry::REFERENCED);
+        pageTable->set(pid, page, entry);
+
+        // Cores only set the bit when they walk to the page, so cached translations go too and the next touch walks again
+        if (shootdownListener) {
+            shootdownListener(pid, page);
         }
     }
+    return referenced;
 }
 
+int PagingAllocator::swapOutVictimPage(const std::unordered_set<int>& runningProcessIDs) {
+    int frameToSwap = replacementPolicy->selectVictim(
+        [this, &runningProcessIDs](int frame) { return runningProcessIDs.find(memory[frame]) == runningProcessIDs.end(); },
+        [this](int frame) { return testAndClearFrameReference(frame); });
 
+    if (frameToSwap == -1) {
+        return -1;
+    }
 
-int PagingAllocator::getUsedMemory(std::vector<std::shared_ptr<Process>> processes) const {
-    int usedMemory = 0;
+    int pid = memory[frameToSwap]; // Read before the swap frees the frame
+    swapOutPage(frameToSwap);
+    return pid;
+}
+
+void PagingAllocator::setShootdownListener(std::function<void(int pid, int page)> listener) {
+    shootdownListener = listener;
+}
 
-    for (const auto& process : processes) {
-        // Get the process ID from the process object
-        int pid = process->getID();
+void PagingAllocator::tickReplacement() {
+    replacementPolicy->tick([this](int frame) { return testAndClearFrameReference(frame); });
+}
+
+void PagingAllocator::swapOutPage(int frame) {
+    int pid = memory[frame];
+    if (pid == -1) {
+        return;
+    }
 
-        // Find the process ID in the process page table
-        auto it = processPageTable.find(pid);
-        if (it != processPageTable.end()) {
-            // Calculate the memory used by this process
-            usedMemory += (it->second.size() * process->getPageSize());
+    int page = framePage[frame];
+    PageTableEntry entry = pageTable->get(pid, page);
+
+    // Only a dirty page is written, a clean one already matches its swap copy or the program
+    if (entry.has(PageTableEntry::DIRTY)) {
+        if (!entry.has(PageTableEntry::IN_SWAP)) {
+            entry.setSwapSlot(backingStore->allocateSlot());
+            entry.set(PageTableEntry::IN_SWAP);
         }
+        backingStore->writePage(entry.getSwapSlot(), pid, page);
+        ++numDirtyPagesWritten;
+    }
+    else {
+        ++numCleanPagesDropped;
     }
 
-    return usedMemory;
+    entry.clear(PageTableEntry::PRESENT | PageTableEntry::DIRTY | PageTableEntry::REFERENCED);
+    pageTable->set(pid, page, entry);
+    releaseFrame(frame); // Mark frame as free
+    ++numPagesPagedOut;
+
+    if (shootdownListener) {
+        shootdownListener(pid, page);
+    }
+}
+
+int PagingAllocator::getUsedMemory() const {
+    return static_cast<int>(occupiedFrames.size()) * pageSize;
 }
 
 std::vector<int> PagingAllocator::getProcessKeys() const {
-    std::vector<int> processIDs;
-    for (const auto& entry : processPageTable) {
-        processIDs.push_back(entry.first);
-    }
-    return processIDs;
+    return pageTable->getProcessIDs();
 }
 
 int PagingAllocator::getNumPagesPagedIn() const {
@@ -153,11 +264,31 @@ int PagingAllocator::getNumPagesPagedOut() const {
     return numPagesPagedOut;
 }
 
+int PagingAllocator::getNumPageFaults() const {
+    return numPageFaults;
+}
+
+int PagingAllocator::getNumPagesReadAhead() const {
+    return numPagesReadAhead;
+}
+
+int PagingAllocator::getNumDirtyPagesWritten() const {
+    return numDirtyPagesWritten;
+}
+
+int PagingAllocator::getNumCleanPagesDropped() const {
+    return numCleanPagesDropped;
+}
+
+size_t PagingAllocator::getPageTableBytes() const {
+    return pageTable ? pageTable->getMemoryBytes() : 0; // Only created when paging is the configured allocator
+}
+
 int PagingAllocator::getInactiveMemory(const std::unordered_set<int>& runningProcessIDs) const {
     int inactiveMemory = 0;
-    for (const auto& entry : processPageTable) {
-        if (runningProcessIDs.find(entry.first) == runningProcessIDs.end()) {
-            inactiveMemory += entry.second.size() * pageSize;
+    for (int frame : occupiedFrames) {
+        if (runningProcessIDs.find(memory[frame]) == runningProcessIDs.end()) {
+            inactiveMemory += pageSize;
         }
     }
     return inactiveMemory;
@@ -5,37 +5,76 @@
 #include <memory>
 #include <functional>
 #include <unordered_set>
+#include <cstdint>
 #include "Process.h"
 #include "ConfigurationManager.h"
+#include "ReplacementPolicy.h"
+#include "PageTable.h"
+#include "BackingStore.h"
 
 class PagingAllocator
 {
 public:
     PagingAllocator();
 
-    void initialize(ConfigurationManager* configManager);
-    bool allocate(Process process, std::function<void(std::shared_ptr<Process>)> swapOutCallback);
+    void initialize(ConfigurationManager* configManager, BackingStore* backingStore);
+    bool allocate(const Process& process); // Registers an empty page table, pages are brought in when first touched
     void deallocate(int pid);
 
-    int getUsedMemory(std::vector<std::shared_ptr<Process>> processes) const;
+    // Demand paging
+    bool isAllocated(int pid) const;
+    bool isPageResident(int pid, int page) const;
+    bool referencePage(int pid, int page); // A core walked to the page, sets its reference bit, false if it is not resident
+    bool loadPage(int pid, int page, const std::unordered_set<int>& protectedProcessIDs); // Service a page fault and read ahead, false if every frame belongs to a protected process
+    bool prefetchPage(int pid, int page); // Bring a page in ahead of its fault, only into a free frame
+    void markDirty(int pid, int page); // The core wrote to a resident page
+
+    int getUsedMemory() const;
     std::vector<int> getProcessKeys() const;
-    int swapOutRandomPage(const std::unordered_set<int>& runningProcessIDs, std::function<void(std::shared_ptr<Process>)> swapOutCallback);
+    int swapOutVictimPage(const std::unordered_set<int>& runningProcessIDs); // Evict the page the replacement policy picks, returns its owner
+    void tickReplacement(); // Periodic reference sampling for aging policies
+    void setShootdownListener(std::function<void(int pid, int page)> listener); // Told about every page swapped out or whose reference bit was cleared
 
     int getNumPagesPagedIn() const;
     int getNumPagesPagedOut() const;
+    int getNumPageFaults() const;
+    int getNumPagesReadAhead() const; // Pages brought in by read-ahead or prefetch rather than a fault
+    int getNumDirtyPagesWritten() const; // Evictions that wrote the page to the backing store
+    int getNumCleanPagesDropped() const; // Evictions that only dropped the frame
+    size_t getPageTableBytes() const; // Page table memory over every process
 
     int getInactiveMemory(const std::unordered_set<int>& runningProcessIDs) const;
 
 private:
     ConfigurationManager* configManager;
+    BackingStore* backingStore;
     int memorySize;
     int pageSize;
     int numPagesPagedIn;
     int numPagesPagedOut;
+    int numPageFaults;
+    int numDirtyPagesWritten;
+    int numCleanPagesDropped;
+    int numPagesReadAhead;
+    int readAheadPages; // Neighbouring pages brought in after each faulted page
+
+    std::unique_ptr<ReplacementPolicy> replacementPolicy; // Slots are frames
+    std::function<void(int pid, int page)> shootdownListener;
+
+    std::vector<int> memory; // memory represented as page frames, holding the owner's PID
+    std::vector<int> framePage; // frame -> virtual page it holds
+    std::unique_ptr<PageTable> pageTable; // Layout chosen by the page-table config key
 
-    std::vector<int> memory; // memory represented as page frames
-    std::unordered_map<int, std::vector<int>> processPageTable; // map of process id to page frames
+    // Frame bookkeeping, kept in sync by takeFreeFrame and releaseFrame
+    std::vector<uint64_t> freeFrameBitmap; // One bit per frame, set while the frame is free
+    std::vector<int> freeFrames; // Stack of free frames, allocation pops from the top
+    std::vector<int> occupiedFrames; // Frames holding a page, victims are drawn from here
+    std::vector<int> occupiedPosition; // frame -> index in occupiedFrames, -1 while free
 
-    int findFreeFrame();
-    void swapOutPage(int frame, std::function<void(std::shared_ptr<Process>)> swapOutCallback);
+    int findFreeFrame(); // Claim a free frame, -1 if memory is full
+    void mapPage(int pid, int page, int frame, bool referenced); // Fill a claimed frame from the swap copy or the program
+    void releaseFrame(int frame);
+    bool isFrameFree(int frame) const;
+    bool testAndClearFrameReference(int frame);
+    void swapOutPage(int frame);
 };
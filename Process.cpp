@@ -1,7 +1,8 @@
 #include "Process.h"
 #include <iostream>
+#include <algorithm>
 
-Process::Process() : id(0), totalInstructions(0), memorySize(0), pageSize(0) {
+Process::Process() : id(0), core(-1), state(State::NEW), currentInstruction(0), totalInstructions(0), memorySize(0), pageSize(0) {
 	// Initialize other members if needed
 }
 
@@ -11,10 +12,11 @@ Process::Process(std::string name, int id, int totalInstructions, float memorySi
 		currentInstruction(0), 
 		totalInstructions(totalInstructions), 
 		core(-1), 
-		finished(false), 
+		state(State::NEW), 
 		creationTime(std::chrono::system_clock::now()),
 		memorySize(memorySize),
-		pageSize(pageSize)
+		pageSize(pageSize),
+		generator(totalInstructions, static_cast<uint32_t>(id))
 
 {}
 
@@ -47,7 +49,7 @@ void Process::setCore(int coreID) {
 };
 
 bool Process::isFinished() const {
-	return finished;
+	return state.load(std::memory_order_acquire) == State::FINISHED;
 }
 
 std::string Process::getCreationTime() const {
@@ -67,10 +69,205 @@ float Process::getPageSize() const {
 	return pageSize;
 }
 
+int Process::getNumPages() const {
+	return std::max(1, static_cast<int>(pageSize));
+}
+
+int Process::getCurrentPage() const {
+	// The program is laid out evenly over the pages, so the page follows the execution progress
+	if (totalInstructions <= 0) {
+		return 0;
+	}
+	int numPages = getNumPages();
+	long long page = static_cast<long long>(currentInstruction.load(std::memory_order_relaxed)) * numPages / totalInstructions;
+	return static_cast<int>(std::min<long long>(page, numPages - 1));
+}
+
+int Process::getPriorityLevel() const {
+	return priorityLevel;
+}
+
+void Process::setPriorityLevel(int level) {
+	priorityLevel = level;
+}
+
+ProcessHandle Process::getHandle() const {
+	return handle;
+}
+
+void Process::setHandle(ProcessHandle newHandle) {
+	handle = newHandle;
+}
+
+Process::State Process::getState() const {
+	return state.load(std::memory_order_acquire);
+}
+
+void Process::setState(State newState) {
+	state.store(newState, std::memory_order_release);
+}
+
+bool Process::transition(State from, State to) {
+	return state.compare_exchange_strong(from, to, std::memory_order_acq_rel);
+}
+
+const char* Process::toString(State state) {
+	switch (state) {
+	case State::NEW: return "NEW";
+	case State::READY: return "READY";
+	case State::RUNNING: return "RUNNING";
+	case State::WAITING: return "WAITING";
+	case State::BLOCKED: return "BLOCKED";
+	case State::SWAPPED: return "SWAPPED";
+	case State::FINISHED: return "FINISHED";
+	}
+	return "UNKNOWN";
+}
+
+void Process::markArrived(std::chrono::nanoseconds now) {
+	long long unset = -1;
+	arrivalTime.compare_exchange_strong(unset, now.count());
+}
+
+void Process::markDispatched(std::chrono::nanoseconds now) {
+	long long unset = -1;
+	firstDispatchTime.compare_exchange_strong(unset, now.count());
+	transition(State::READY, State::RUNNING); // A process swapped out while queued stays SWAPPED for the core to notice
+}
+
+void Process::markCompleted(std::chrono::nanoseconds now) {
+	long long unset = -1;
+	completionTime.compare_exchange_strong(unset, now.count());
+}
+
+long long Process::getArrivalTime() const {
+	return arrivalTime;
+}
+
+long long Process::getFirstDispatchTime() const {
+	return firstDispatchTime;
+}
+
+long long Process::getCompletionTime() const {
+	return completionTime;
+}
+
+long long Process::getResponseTime() const {
+	long long dispatched = firstDispatchTime;
+	long long arrived = arrivalTime;
+	return (dispatched < 0 || arrived < 0) ? -1 : dispatched - arrived;
+}
+
+long long Process::getTurnaroundTime() const {
+	long long completed = completionTime;
+	long long arrived = arrivalTime;
+	return (completed < 0 || arrived < 0) ? -1 : completed - arrived;
+}
+
 void Process::execute() {
-	if (currentInstruction < totalInstructions) { // If the process has not finished executing
-		currentInstruction++; // Increment the current instruction
-	} else {
-		finished = true; // Set the process to finished
+	wroteMemory = false;
+
+	// A sleeping process burns the tick without executing anything. It stays WAITING through preemption
+	// and requeueing, and only runs again as RUNNING once the sleep is over
+	if (sleepTicks > 0) {
+		if (--sleepTicks == 0) {
+			transition(State::WAITING, State::RUNNING);
+		}
+		return;
+	}
+
+	// Decode the next chunk once the current one is used up, loops never span two chunks
+	if (programCounter >= chunk.size()) {
+		if (!generator.nextChunk(chunk)) {
+			std::vector<Instruction>().swap(chunk); // Release the buffer, a finished process keeps no instructions
+			setState(State::FINISHED); // Set the process to finished
+			return;
+		}
+		programCounter = 0;
+	}
+
+	const Instruction& instruction = chunk[programCounter++];
+	switch (instruction.opcode) {
+	case Opcode::PRINT:
+		print(instruction);
+		break;
+	case Opcode::DECLARE:
+		variables[instruction.dest].store(instruction.a, std::memory_order_relaxed);
+		wroteMemory = true;
+		break;
+	case Opcode::ADD: {
+		int sum = readOperand(instruction.a, instruction.flags & Instruction::OPERAND_A_IS_VARIABLE)
+			+ readOperand(instruction.b, instruction.flags & Instruction::OPERAND_B_IS_VARIABLE);
+		variables[instruction.dest].store(static_cast<uint16_t>(std::min(sum, static_cast<int>(UINT16_MAX))), std::memory_order_relaxed);
+		wroteMemory = true;
+		break;
+	}
+	case Opcode::SUBTRACT: {
+		int difference = readOperand(instruction.a, instruction.flags & Instruction::OPERAND_A_IS_VARIABLE)
+			- readOperand(instruction.b, instruction.flags & Instruction::OPERAND_B_IS_VARIABLE);
+		variables[instruction.dest].store(static_cast<uint16_t>(std::max(difference, 0)), std::memory_order_relaxed);
+		wroteMemory = true;
+		break;
+	}
+	case Opcode::SLEEP:
+		sleepTicks = instruction.a;
+		if (sleepTicks > 0) {
+			transition(State::RUNNING, State::WAITING);
+		}
+		break;
+	case Opcode::FOR:
+		loopStack[loopDepth++] = { programCounter, instruction.a };
+		break;
+	case Opcode::END_FOR:
+		if (--loopStack[loopDepth - 1].remaining > 0) {
+			programCounter = loopStack[loopDepth - 1].bodyStart; // Next iteration
+		}
+		else {
+			loopDepth--;
+		}
+		break;
+	}
+
+	currentInstruction.fetch_add(1, std::memory_order_release); // Increment the current instruction
+}
+
+bool Process::didWriteMemory() const {
+	return wroteMemory;
+}
+
+void Process::markReferenced() {
+	// Skip the store when the bit is already set so a running process does not keep dirtying the cache line
+	if (!referenced.load(std::memory_order_relaxed)) {
+		referenced.store(true, std::memory_order_relaxed);
+	}
+}
+
+bool Process::testAndClearReferenced() {
+	return referenced.exchange(false, std::memory_order_relaxed);
+}
+
+uint16_t Process::readOperand(uint16_t operand, bool isVariable) const {
+	return isVariable ? variables[operand].load(std::memory_order_relaxed) : operand;
+}
+
+void Process::print(const Instruction& instruction) {
+	std::string message;
+	if (instruction.flags & Instruction::OPERAND_A_IS_VARIABLE) {
+		message = "Value of v" + std::to_string(instruction.a) + ": " + std::to_string(variables[instruction.a].load(std::memory_order_relaxed));
 	}
+	else {
+		message = "Hello world from " + processName + "!";
+	}
+
+	std::lock_guard<std::mutex> lock(logMutex);
+	logs.push_back("Core:" + std::to_string(core.load()) + " \"" + message + "\"");
+}
+
+std::vector<std::string> Process::getLogs() const {
+	std::lock_guard<std::mutex> lock(logMutex);
+	return logs;
+}
+
+uint16_t Process::getVariable(int index) const {
+	return variables[index].load(std::memory_order_relaxed);
 }
\ No newline at end of file
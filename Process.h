@@ -1,12 +1,25 @@
 #pragma once
 #include <chrono>
 #include <string>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+#include "ProcessHandle.h"
+#include "Instruction.h"
+#include "InstructionGenerator.h"
 
 class Process
 {
 public:
+	// Lifecycle, every transition is a single atomic store or compare-exchange so readers never see a torn state
+	enum class State { NEW, READY, RUNNING, WAITING, BLOCKED, SWAPPED, FINISHED }; // BLOCKED is off every core until a faulted page is brought in
+
 	Process();
 	Process(std::string name, int id, int totalInstructions, float memorySize, float pageSize);
+	Process(const Process&) = delete; // Owned by the ProcessTable, shared by pointer only
+	Process& operator=(const Process&) = delete;
 
 	std::string getName() const;
 	int getID() const;
@@ -19,21 +32,75 @@ public:
 	std::string getCreationTime() const;
 	float getMemorySize() const;
 	float getPageSize() const;
+	int getNumPages() const; // Virtual pages in the address space, at least one
+	int getCurrentPage() const; // Page the next instruction touches
+	int getPriorityLevel() const;
+	void setPriorityLevel(int level);
+	ProcessHandle getHandle() const;
+	void setHandle(ProcessHandle newHandle);
+
+	State getState() const;
+	void setState(State newState);
+	bool transition(State from, State to); // Moves to the new state only if still in the expected one
+	static const char* toString(State state);
 
-	void execute(); // Executes one instruction
+	// Monotonic timestamps in simulated nanoseconds, -1 until the event happens
+	void markArrived(std::chrono::nanoseconds now); // Entered the ready queue for the first time
+	void markDispatched(std::chrono::nanoseconds now); // Placed on a core, the first call records the response time
+	void markCompleted(std::chrono::nanoseconds now);
+	long long getArrivalTime() const;
+	long long getFirstDispatchTime() const;
+	long long getCompletionTime() const;
+	long long getResponseTime() const; // First dispatch - arrival, -1 if not dispatched yet
+	long long getTurnaroundTime() const; // Completion - arrival, -1 if not finished yet
+
+	void execute(); // Executes one instruction, or one tick of a SLEEP
+	bool didWriteMemory() const; // The last executed instruction stored to a variable
+	void markReferenced(); // Set by the core after executing, read by flat and buddy replacement, paging tracks pages instead
+	bool testAndClearReferenced();
+	std::vector<std::string> getLogs() const; // Output of the PRINT instructions so far
+	uint16_t getVariable(int index) const; // Safe to call while the process runs
 
 private:
 	std::string processName;
 	int id;
-	int core;
-	std::string status;
+	std::atomic<int> core;
 	std::chrono::system_clock::time_point creationTime;
 
-	bool finished;
-	int currentInstruction;
+	std::atomic<State> state;
+	std::atomic<int> currentInstruction;
 	int totalInstructions;
+
+	std::atomic<long long> arrivalTime{ -1 };
+	std::atomic<long long> firstDispatchTime{ -1 };
+	std::atomic<long long> completionTime{ -1 };
+	std::atomic<bool> referenced{ false }; // Reference bit, set on every executed tick until replacement samples it
 	
 	float memorySize;
 	float pageSize;
+
+	int priorityLevel = 0; // MLFQ level, 0 is the highest priority
+
+	// Interpreter state, only touched by the core running the process
+	struct LoopFrame {
+		uint32_t bodyStart; // Index of the first instruction in the loop body
+		uint16_t remaining; // Iterations left, including the current one
+	};
+
+	InstructionGenerator generator; // Seed and progress of the program, instructions are decoded from it on demand
+	std::vector<Instruction> chunk; // Instructions being executed, empty until the process first runs and once it finishes
+	uint32_t programCounter = 0; // Index into chunk
+	std::atomic<uint16_t> variables[InstructionGenerator::NUM_VARIABLES] = {}; // Atomic since the process screen reads them while the core writes
+	LoopFrame loopStack[InstructionGenerator::MAX_LOOP_DEPTH] = {};
+	int loopDepth = 0;
+	int sleepTicks = 0; // Ticks left in the current SLEEP
+	bool wroteMemory = false; // Set by DECLARE, ADD and SUBTRACT
+
+	std::vector<std::string> logs;
+	mutable std::mutex logMutex; // Guards logs, which the process screen reads while the process runs
+
+	uint16_t readOperand(uint16_t operand, bool isVariable) const;
+	void print(const Instruction& instruction);
+	ProcessHandle handle; // Slot in the ProcessTable that owns this process
 };
 
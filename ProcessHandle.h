@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// Reference to a slot in the ProcessTable. The generation is bumped whenever the slot
+// is released, so a handle kept past its process's lifetime resolves to nothing
+// instead of to whichever process reuses the slot.
+struct ProcessHandle
+{
+    static const uint32_t INVALID_INDEX = UINT32_MAX;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    bool operator==(const ProcessHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const ProcessHandle& other) const { return !(*this == other); }
+};
@@ -0,0 +1,90 @@
+#include "ProcessRegistry.h"
+
+#include <algorithm>
+
+ProcessRegistry::ProcessRegistry() : retiredSlots(0) {}
+
+bool ProcessRegistry::add(std::shared_ptr<Process> process) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (nameIndex.count(process->getName()) || retiredNames.count(process->getName()) || idIndex.count(process->getID())) {
+        return false;
+    }
+
+    nameIndex[process->getName()] = processes.size();
+    idIndex[process->getID()] = processes.size();
+    processes.push_back(process);
+    return true;
+}
+
+std::shared_ptr<Process> ProcessRegistry::findByName(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = nameIndex.find(name);
+    return it != nameIndex.end() ? processes[it->second] : nullptr;
+}
+
+std::shared_ptr<Process> ProcessRegistry::findByID(int pid) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = idIndex.find(pid);
+    return it != idIndex.end() ? processes[it->second] : nullptr;
+}
+
+bool ProcessRegistry::contains(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return nameIndex.find(name) != nameIndex.end() || retiredNames.find(name) != retiredNames.end();
+}
+
+void ProcessRegistry::retire(const std::shared_ptr<Process>& process) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = idIndex.find(process->getID());
+    if (it == idIndex.end()) {
+        return;
+    }
+
+    FinishedProcessRecord record;
+    record.name = process->getName();
+    record.id = process->getID();
+    record.creationTime = process->getCreationTime();
+    record.core = process->getCore();
+    record.totalInstructions = process->getTotalInstructions();
+    record.responseTime = process->getResponseTime();
+    record.turnaroundTime = process->getTurnaroundTime();
+    finished.push_back(record);
+
+    processes[it->second] = nullptr;
+    nameIndex.erase(record.name);
+    idIndex.erase(it);
+    retiredNames.insert(record.name);
+    retiredSlots++;
+
+    // Drop the holes once they outnumber the live processes, so listings stay proportional to what is running
+    if (retiredSlots * 2 >= processes.size()) {
+        processes.erase(std::remove(processes.begin(), processes.end(), nullptr), processes.end());
+        for (size_t i = 0; i < processes.size(); i++) {
+            nameIndex[processes[i]->getName()] = i;
+            idIndex[processes[i]->getID()] = i;
+        }
+        retiredSlots = 0;
+    }
+}
+
+std::vector<std::shared_ptr<Process>> ProcessRegistry::getAll() const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<std::shared_ptr<Process>> live;
+    live.reserve(processes.size() - retiredSlots);
+    for (const auto& process : processes) {
+        if (process) {
+            live.push_back(process);
+        }
+    }
+    return live;
+}
+
+std::vector<FinishedProcessRecord> ProcessRegistry::getFinished() const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return finished;
+}
+
+size_t ProcessRegistry::size() const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return processes.size() - retiredSlots;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Process.h"
+
+// What the listings still need of a finished process once its slot in the ProcessTable is reused
+struct FinishedProcessRecord {
+    std::string name;
+    int id;
+    std::string creationTime;
+    int core;
+    int totalInstructions;
+    long long responseTime;
+    long long turnaroundTime;
+};
+
+// Every process ever created, kept in creation order with hash indexes by name and PID
+// so lookups stay constant-time no matter how many processes have been created.
+class ProcessRegistry
+{
+public:
+    ProcessRegistry();
+
+    bool add(std::shared_ptr<Process> process); // False if the name or PID is already registered
+
+    std::shared_ptr<Process> findByName(const std::string& name) const;
+    std::shared_ptr<Process> findByID(int pid) const;
+    bool contains(const std::string& name) const; // Also true for retired processes, their names stay taken
+
+    // Swap a finished process for its record before its slot is released, the find functions stop resolving it
+    void retire(const std::shared_ptr<Process>& process);
+
+    std::vector<std::shared_ptr<Process>> getAll() const; // Live processes in creation order, safe to iterate while processes are added
+    std::vector<FinishedProcessRecord> getFinished() const; // Retired processes in completion order
+    size_t size() const; // Live processes
+
+private:
+    mutable std::mutex registryMutex;
+    std::vector<std::shared_ptr<Process>> processes; // Creation order, for listings, nullptr where a process was retired
+    std::vector<FinishedProcessRecord> finished;
+    std::unordered_set<std::string> retiredNames;
+    size_t retiredSlots; // nullptr entries in processes, compacted once they are half of it
+    std::unordered_map<std::string, size_t> nameIndex; // Name -> position in processes
+    std::unordered_map<int, size_t> idIndex; // PID -> position in processes
+};
@@ -5,8 +5,8 @@
 
 extern ConsoleManager consoleManager;
 
-ProcessScreen::ProcessScreen(std::shared_ptr<Process> myProcess)
-	: AConsole("PROCESS_SCREEN_" + myProcess->getName()), thisProcess(myProcess) {
+ProcessScreen::ProcessScreen(ProcessTable* processTable, ProcessHandle myProcess)
+	: AConsole("PROCESS_SCREEN_" + processTable->get(myProcess)->getName()), processTable(processTable), processHandle(myProcess) {
 }
 
 void ProcessScreen::onExecute() {
@@ -32,11 +32,24 @@ void ProcessScreen::process() {
 
 void ProcessScreen::displayHeader() {
     std::cout << "--------------------------" << endl;
+    std::shared_ptr<Process> thisProcess = processTable->get(processHandle);
+    if (!thisProcess) {
+        std::cout << "Process no longer exists." << endl;
+        return;
+    }
+
     // Displays process name and ID
     std::cout << "Process: " << thisProcess->getName() << endl;
     std::cout << "Memory: " << thisProcess->getMemorySize() << endl;
     std::cout << "ID: " << thisProcess->getID() << endl << endl;
 
+    // Output of the PRINT instructions executed so far
+    std::cout << "Logs:" << endl;
+    for (const auto& line : thisProcess->getLogs()) {
+        std::cout << line << endl;
+    }
+    std::cout << endl;
+
     // Prints finished if process is done else print current line and total lines
     if (!thisProcess->isFinished()) {
         std::cout << "Current instruction line: " << thisProcess->getCurrentInstruction() << endl;
@@ -1,6 +1,7 @@
 #pragma once
 #include "AConsole.h"
 #include "Process.h"
+#include "ProcessTable.h"
 #include <iostream>
 #include <vector>
 #include <sstream>
@@ -8,7 +9,7 @@
 class ProcessScreen : public AConsole
 {
 public:
-	ProcessScreen(std::shared_ptr<Process> myProcess);
+	ProcessScreen(ProcessTable* processTable, ProcessHandle myProcess);
 
 	void onExecute() override; // Main loop
 	void display() override;
@@ -18,6 +19,7 @@ private:
 	void displayHeader();
 	bool handleCommand(string command);
 
-	std::shared_ptr<Process> thisProcess;
+	ProcessTable* processTable;
+	ProcessHandle processHandle; // Resolved on every redraw so the view stays live
 };
 
@@ -0,0 +1,114 @@
+#include "ProcessTable.h"
+
+#include <new>
+
+ProcessTable::ProcessTable() : nextSlot(0), liveCount(0) {}
+
+ProcessTable::~ProcessTable() {
+    // Each slot's control block holds its chunk, drop the table's strong and weak references so the chunks can go
+    for (uint32_t index = 0; index < nextSlot; index++) {
+        slotAt(index).owner.reset();
+        slotAt(index).pointers.reset();
+    }
+}
+
+ProcessHandle ProcessTable::create(std::string name, int id, int totalInstructions, float memorySize, float pageSize) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+
+    if (freeSlots.empty()) {
+        reclaimRetiredSlots();
+    }
+
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        index = nextSlot++;
+        if (index / CHUNK_SIZE >= chunks.size()) {
+            chunks.push_back(std::make_shared<Chunk>()); // One allocation per CHUNK_SIZE processes
+        }
+    }
+
+    Slot& slot = slotAt(index);
+    ProcessHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+
+    // Processes are not copyable, rebuild the slot's process in place
+    slot.process.~Process();
+    new (&slot.process) Process(name, id, totalInstructions, memorySize, pageSize);
+    slot.process.setHandle(handle);
+    slot.inUse = true;
+    liveCount++;
+
+    // The deleter only keeps the chunk alive, the slot is rebuilt by a later create once the pointers expire
+    std::shared_ptr<Chunk> chunk = chunks[index / CHUNK_SIZE];
+    slot.owner = std::shared_ptr<Process>(&slot.process, [chunk](Process*) {});
+    slot.pointers = slot.owner;
+
+    return handle;
+}
+
+std::shared_ptr<Process> ProcessTable::get(ProcessHandle handle) const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    Slot* slot = findSlot(handle);
+    if (!slot) {
+        return nullptr;
+    }
+
+    return slot->owner;
+}
+
+bool ProcessTable::isValid(ProcessHandle handle) const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    return findSlot(handle) != nullptr;
+}
+
+void ProcessTable::release(ProcessHandle handle) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    Slot* slot = findSlot(handle);
+    if (!slot) {
+        return;
+    }
+
+    slot->inUse = false;
+    slot->generation++; // Outstanding handles to this slot go stale
+    slot->owner.reset();
+    retiredSlots.push_back(handle.index);
+    liveCount--;
+}
+
+size_t ProcessTable::size() const {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    return liveCount;
+}
+
+ProcessTable::Slot* ProcessTable::findSlot(ProcessHandle handle) const {
+    if (!handle.isValid() || handle.index >= nextSlot) {
+        return nullptr;
+    }
+
+    Slot* slot = &slotAt(handle.index);
+    if (!slot->inUse || slot->generation != handle.generation) {
+        return nullptr;
+    }
+    return slot;
+}
+
+ProcessTable::Slot& ProcessTable::slotAt(uint32_t index) const {
+    return chunks[index / CHUNK_SIZE]->slots[index % CHUNK_SIZE];
+}
+
+void ProcessTable::reclaimRetiredSlots() {
+    for (auto it = retiredSlots.begin(); it != retiredSlots.end();) {
+        if (slotAt(*it).pointers.expired()) {
+            freeSlots.push_back(*it);
+            it = retiredSlots.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
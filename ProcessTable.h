@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+#include "Process.h"
+#include "ProcessHandle.h"
+
+// Slab that owns every Process in the emulator. Slots are carved out of fixed-size chunks
+// that never move, so creating a process costs only a small control block, and the pointers
+// handed to the Scheduler, the MemoryManager and the screens all refer to the one copy.
+// Pointers returned by get() share that control block, which keeps the chunk alive and tells
+// the table when a released slot can be rebuilt.
+class ProcessTable
+{
+public:
+    ProcessTable();
+    ~ProcessTable();
+
+    ProcessHandle create(std::string name, int id, int totalInstructions, float memorySize, float pageSize);
+    std::shared_ptr<Process> get(ProcessHandle handle) const; // nullptr if the handle is stale
+    bool isValid(ProcessHandle handle) const;
+
+    // Free the slot for reuse, only once the process is off every queue and core. The slot is rebuilt
+    // only after the last pointer from get() is gone, readers such as status snapshots may still hold one
+    void release(ProcessHandle handle);
+
+    size_t size() const; // Live processes
+
+    static const size_t CHUNK_SIZE = 256;
+
+private:
+    struct Slot {
+        Process process;
+        uint32_t generation = 0;
+        bool inUse = false;
+        std::shared_ptr<Process> owner; // The table's own reference while in use
+        std::weak_ptr<Process> pointers; // Expires once the table and every get() caller let go
+    };
+
+    struct Chunk {
+        Slot slots[CHUNK_SIZE];
+    };
+
+    mutable std::mutex tableMutex;
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    std::vector<uint32_t> freeSlots; // Released slot indexes nothing points into anymore, reused before growing
+    std::vector<uint32_t> retiredSlots; // Released slot indexes still pointed to, moved to freeSlots once unpinned
+    uint32_t nextSlot; // First never-used slot index
+    size_t liveCount;
+
+    // The following are called with tableMutex held
+    Slot* findSlot(ProcessHandle handle) const; // nullptr if the handle is stale
+    Slot& slotAt(uint32_t index) const;
+    void reclaimRetiredSlots();
+};
@@ -0,0 +1,92 @@
+#include "ReadyQueue.h"
+
+#include <cstdint>
+
+ReadyQueue::ReadyQueue(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+    // Round the capacity up to a power of two so positions can be masked instead of divided
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    buffer = new Cell[size];
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+ReadyQueue::~ReadyQueue() {
+    delete[] buffer;
+}
+
+bool ReadyQueue::push(std::shared_ptr<Process> process) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+        cell = &buffer[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0) {
+            // Cell is free for this lap, try to claim it
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return false; // Queue is full
+        }
+        else {
+            pos = enqueuePos.load(std::memory_order_relaxed); // Another producer claimed it, retry
+        }
+    }
+
+    cell->process = std::move(process);
+    cell->sequence.store(pos + 1, std::memory_order_release); // Publish to consumers
+    return true;
+}
+
+bool ReadyQueue::pop(std::shared_ptr<Process>& process) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+        cell = &buffer[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+        if (diff == 0) {
+            // Cell holds a published process, try to claim it
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return false; // Queue is empty
+        }
+        else {
+            pos = dequeuePos.load(std::memory_order_relaxed); // Another consumer claimed it, retry
+        }
+    }
+
+    process = std::move(cell->process);
+    cell->process.reset();
+    cell->sequence.store(pos + mask + 1, std::memory_order_release); // Free the cell for the next lap
+    return true;
+}
+
+bool ReadyQueue::empty() const {
+    return size() == 0;
+}
+
+size_t ReadyQueue::size() const {
+    size_t head = dequeuePos.load(std::memory_order_acquire);
+    size_t tail = enqueuePos.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+}
+
+size_t ReadyQueue::capacity() const {
+    return mask + 1;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+#include "Process.h"
+
+// Bounded lock-free multi-producer/multi-consumer queue of ready processes.
+// Each cell carries a sequence number that tells producers and consumers whether
+// the cell is free for the current lap around the ring buffer, so push and pop
+// only need a single compare-and-swap on their own position counter.
+class ReadyQueue
+{
+public:
+    explicit ReadyQueue(size_t capacity = DEFAULT_CAPACITY); // Capacity is rounded up to a power of two
+    ~ReadyQueue();
+
+    ReadyQueue(const ReadyQueue&) = delete;
+    ReadyQueue& operator=(const ReadyQueue&) = delete;
+
+    bool push(std::shared_ptr<Process> process); // Returns false if the queue is full
+    bool pop(std::shared_ptr<Process>& process); // Returns false if the queue is empty
+
+    bool empty() const; // Snapshot, may be stale by the time the caller acts on it
+    size_t size() const; // Snapshot of the number of queued processes
+    size_t capacity() const;
+
+    static const size_t DEFAULT_CAPACITY = 1 << 17;
+    static const size_t CACHE_LINE = 64;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        std::shared_ptr<Process> process;
+    };
+
+    Cell* buffer;
+    size_t mask;
+
+    // Kept on separate cache lines so producers and consumers do not false-share. Padded with bytes rather than
+    // alignas, which would make the queue over-aligned and is not honoured by new under C++14, and a whole line
+    // apart so they never share one wherever the owning object lands
+    char enqueuePadding[CACHE_LINE];
+    std::atomic<size_t> enqueuePos;
+    char dequeuePadding[CACHE_LINE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeuePos;
+    char trailingPadding[CACHE_LINE - sizeof(std::atomic<size_t>)];
+};
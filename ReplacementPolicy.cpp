@@ -0,0 +1,171 @@
+#include "ReplacementPolicy.h"
+
+std::unique_ptr<ReplacementPolicy> ReplacementPolicy::create(const std::string& name) {
+    if (name == "fifo") {
+        return std::unique_ptr<ReplacementPolicy>(new FIFOReplacementPolicy());
+    }
+    if (name == "second-chance") {
+        return std::unique_ptr<ReplacementPolicy>(new SecondChanceReplacementPolicy());
+    }
+    if (name == "clock") {
+        return std::unique_ptr<ReplacementPolicy>(new ClockReplacementPolicy());
+    }
+    if (name == "lru") {
+        return std::unique_ptr<ReplacementPolicy>(new LRUReplacementPolicy());
+    }
+    return nullptr;
+}
+
+// FIFO
+
+void FIFOReplacementPolicy::onInsert(int slot) {
+    if (positions.count(slot)) {
+        return;
+    }
+    positions[slot] = queue.insert(queue.end(), slot);
+}
+
+void FIFOReplacementPolicy::onRemove(int slot) {
+    auto it = positions.find(slot);
+    if (it != positions.end()) {
+        queue.erase(it->second);
+        positions.erase(it);
+    }
+}
+
+int FIFOReplacementPolicy::selectVictim(const SlotFilter& canEvict, const SlotFilter& /*testAndClearReference*/) {
+    for (int slot : queue) {
+        if (canEvict(slot)) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+// Second chance
+
+void SecondChanceReplacementPolicy::onInsert(int slot) {
+    if (positions.count(slot)) {
+        return;
+    }
+    positions[slot] = queue.insert(queue.end(), slot);
+}
+
+void SecondChanceReplacementPolicy::onRemove(int slot) {
+    auto it = positions.find(slot);
+    if (it != positions.end()) {
+        queue.erase(it->second);
+        positions.erase(it);
+    }
+}
+
+int SecondChanceReplacementPolicy::selectVictim(const SlotFilter& canEvict, const SlotFilter& testAndClearReference) {
+    // Two passes are enough, the first clears every reference bit it meets
+    size_t budget = 2 * queue.size();
+    for (size_t i = 0; i < budget && !queue.empty(); i++) {
+        int slot = queue.front();
+        if (!testAndClearReference(slot) && canEvict(slot)) {
+            return slot;
+        }
+
+        // Referenced or pinned, give it another round at the tail
+        queue.splice(queue.end(), queue, queue.begin());
+    }
+    return -1;
+}
+
+// CLOCK
+
+void ClockReplacementPolicy::onInsert(int slot) {
+    if (positions.count(slot)) {
+        return;
+    }
+
+    // New slots go just behind the hand so they are the last to be examined
+    auto it = ring.insert(hand, slot);
+    positions[slot] = it;
+    if (hand == ring.end()) {
+        hand = ring.begin();
+    }
+}
+
+void ClockReplacementPolicy::onRemove(int slot) {
+    auto it = positions.find(slot);
+    if (it == positions.end()) {
+        return;
+    }
+
+    if (hand == it->second) {
+        advanceHand();
+    }
+    ring.erase(it->second);
+    positions.erase(it);
+    if (ring.empty()) {
+        hand = ring.end();
+    }
+}
+
+int ClockReplacementPolicy::selectVictim(const SlotFilter& canEvict, const SlotFilter& testAndClearReference) {
+    size_t budget = 2 * ring.size();
+    for (size_t i = 0; i < budget && !ring.empty(); i++) {
+        int slot = *hand;
+        advanceHand();
+        if (!testAndClearReference(slot) && canEvict(slot)) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void ClockReplacementPolicy::advanceHand() {
+    if (hand != ring.end()) {
+        ++hand;
+    }
+    if (hand == ring.end()) {
+        hand = ring.begin();
+    }
+}
+
+// LRU approximation
+
+LRUReplacementPolicy::LRUReplacementPolicy() : buckets(NUM_AGES) {}
+
+void LRUReplacementPolicy::onInsert(int slot) {
+    if (entries.count(slot)) {
+        return;
+    }
+
+    std::list<int>& bucket = buckets[0x80]; // Just loaded counts as just used
+    entries[slot] = { 0x80, bucket.insert(bucket.end(), slot) };
+}
+
+void LRUReplacementPolicy::onRemove(int slot) {
+    auto it = entries.find(slot);
+    if (it != entries.end()) {
+        buckets[it->second.age].erase(it->second.position);
+        entries.erase(it);
+    }
+}
+
+int LRUReplacementPolicy::selectVictim(const SlotFilter& canEvict, const SlotFilter& /*testAndClearReference*/) {
+    // Pinned slots are skipped, so the cost is the empty buckets below the victim plus the pinned slots in them
+    for (const auto& bucket : buckets) {
+        for (int slot : bucket) {
+            if (canEvict(slot)) {
+                return slot;
+            }
+        }
+    }
+    return -1;
+}
+
+void LRUReplacementPolicy::tick(const SlotFilter& testAndClearReference) {
+    for (auto& entry : entries) {
+        Entry& aged = entry.second;
+        uint8_t age = static_cast<uint8_t>((aged.age >> 1) | (testAndClearReference(entry.first) ? 0x80 : 0));
+        if (age != aged.age) {
+            buckets[age].splice(buckets[age].end(), buckets[aged.age], aged.position); // The iterator stays valid
+            aged.age = age;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <list>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+// Chooses what to evict when memory is full. A slot is whatever the allocator evicts as a
+// unit, a frame for paging and a PID for the flat and buddy allocators. The allocator reports
+// slots becoming resident or free, and asks for a victim through two callbacks: canEvict
+// filters out slots that must stay (pages of running processes), testAndClearReference
+// reads and clears the slot's reference bit, which CoreWorker sets by executing instructions.
+// canEvict is asked last, and a slot it accepts is the one returned, so it may claim the slot.
+class ReplacementPolicy
+{
+public:
+    using SlotFilter = std::function<bool(int slot)>;
+
+    virtual ~ReplacementPolicy() {}
+
+    virtual const char* getName() const = 0;
+    virtual void onInsert(int slot) = 0; // Slot became resident
+    virtual void onRemove(int slot) = 0; // Slot was freed or evicted
+    virtual int selectVictim(const SlotFilter& canEvict, const SlotFilter& testAndClearReference) = 0; // -1 if nothing can be evicted
+    virtual void tick(const SlotFilter& /*testAndClearReference*/) {} // Periodic sampling of reference bits, for policies that age slots
+
+    // "fifo", "second-chance", "clock" or "lru", nullptr for anything else
+    static std::unique_ptr<ReplacementPolicy> create(const std::string& name);
+};
+
+// Evicts the slot resident longest, ignoring references
+class FIFOReplacementPolicy : public ReplacementPolicy
+{
+public:
+    const char* getName() const override { return "fifo"; }
+    void onInsert(int slot) override;
+    void onRemove(int slot) override;
+    int selectVictim(const SlotFilter& canEvict, const SlotFilter& testAndClearReference) override;
+
+private:
+    std::list<int> queue; // Oldest first
+    std::unordered_map<int, std::list<int>::iterator> positions;
+};
+
+// FIFO, but a referenced slot at the head has its bit cleared and moves to the tail instead of being evicted
+class SecondChanceReplacementPolicy : public ReplacementPolicy
+{
+public:
+    const char* getName() const override { return "second-chance"; }
+    void onInsert(int slot) override;
+    void onRemove(int slot) override;
+    int selectVictim(const SlotFilter& canEvict, const SlotFilter& testAndClearReference) override;
+
+private:
+    std::list<int> queue; // Oldest first
+    std::unordered_map<int, std::list<int>::iterator> positions;
+};
+
+// Second chance without moving entries, a hand sweeps the resident slots in a circle
+class ClockReplacementPolicy : public ReplacementPolicy
+{
+public:
+    const char* getName() const override { return "clock"; }
+    void onInsert(int slot) override;
+    void onRemove(int slot) override;
+    int selectVictim(const SlotFilter& canEvict, const SlotFilter& testAndClearReference) override;
+
+private:
+    std::list<int> ring;
+    std::list<int>::iterator hand = ring.end();
+    std::unordered_map<int, std::list<int>::iterator> positions;
+
+    void advanceHand();
+};
+
+// Aging LRU approximation, each tick shifts a slot's age right and ORs its reference bit into the top,
+// the slot with the lowest age is the least recently used. Slots sit in one bucket per age, so a victim
+// is found from the lowest age up without scanning every slot; only the tick visits them all
+class LRUReplacementPolicy : public ReplacementPolicy
+{
+public:
+    LRUReplacementPolicy();
+
+    const char* getName() const override { return "lru"; }
+    void onInsert(int slot) override;
+    void onRemove(int slot) override;
+    int selectVictim(const SlotFilter& canEvict, const SlotFilter& testAndClearReference) override;
+    void tick(const SlotFilter& testAndClearReference) override;
+
+    static const int NUM_AGES = 256;
+
+private:
+    struct Entry {
+        uint8_t age;
+        std::list<int>::iterator position; // In buckets[age]
+    };
+
+    std::vector<std::list<int>> buckets; // Age -> slots, longest at that age first
+    std::unordered_map<int, Entry> entries;
+};
@@ -13,13 +13,16 @@ ResourceManager::ResourceManager() : processCounter(0) {
 
 ResourceManager::~ResourceManager() {
 	stopAllocationThread();
+	memoryManager.stop(); // The memory thread calls into the Scheduler, which is destroyed first
 }
 
 bool ResourceManager::initialize(ConfigurationManager* newConfigManager){	
 	configManager = newConfigManager;
+	clock.initialize(configManager);
 
 	// Initialize the scheduler and memory manager
-	if (scheduler.initialize(configManager) && memoryManager.initialize(configManager, &scheduler)) {
+	if (scheduler.initialize(configManager, &clock, &processesMasterList) && memoryManager.initialize(configManager, &scheduler, &clock)) {
+		scheduler.setFinishHandler([this](std::shared_ptr<Process> process) { collectProcess(process); });
 		running = true;
 		startAllocationThread();
 		return true;
@@ -40,42 +43,33 @@ std::shared_ptr<Process> ResourceManager::createProcess(std::string process_name
 	
 
 	// Create a new process
-	auto newProcess = std::make_shared<Process>(process_name, processCounter, randomMaxInstructions, randomMemory, randomPage);
+	auto newProcess = processTable.get(processTable.create(process_name, processCounter, randomMaxInstructions, randomMemory, randomPage));
+	if (!processesMasterList.add(newProcess)) {
+		// The name was taken after the caller checked it, e.g. by the scheduler test loop
+		processTable.release(newProcess->getHandle());
+		return nullptr;
+	}
 	processes.push_back(newProcess);
-	processesMasterList.push_back(newProcess);
 
 	// Notify the allocation thread
+	clock.wake(allocationParticipant);
 	processAdded.notify_all();
 
 	return newProcess;
 }
 
 bool ResourceManager::processExists(std::string name) {
-	auto it = std::find_if(processesMasterList.begin(), processesMasterList.end(),
-		[&name](const std::shared_ptr<Process>& process) {
-			return process->getName() == name;
-		});
-	return it != processesMasterList.end();
+	return processesMasterList.contains(name);
 }
 
 std::shared_ptr<Process> ResourceManager::findProcessByName(const std::string name) {
-	auto it = std::find_if(processesMasterList.begin(), processesMasterList.end(),
-		[&name](const std::shared_ptr<Process>& process) {
-			return process->getName() == name;
-		});
-
-	if (it != processesMasterList.end()) {
-		return *it;
-	}
-	else {
-		return nullptr; // or you could throw an exception if preferred
-	}
+	return processesMasterList.findByName(name);
 }
 
 void ResourceManager::allocateAndScheduleProcesses() {
 	while (running) {
 		std::unique_lock<std::mutex> lock(processMutex);
-		processAdded.wait(lock, [this] { return !running || !processes.empty(); }); // Wait until a process is added or the program is stopped
+		clock.wait(allocationParticipant, lock, processAdded, [this] { return !running || !processes.empty(); }); // Wait until a process is added or the program is stopped
 
 		if (!running) {
 			break;
@@ -88,17 +82,28 @@ void ResourceManager::allocateAndScheduleProcesses() {
 		// Try to allocate memory for the process
 		if (memoryManager.allocate(*process)) {
 			// Add process to the scheduler if memory allocation is successful
-			scheduler.addProcess(*process);
+			scheduler.addProcess(process);
 		}
 		else {
 			std::lock_guard<std::mutex> lock(processMutex);
 			processes.erase(std::remove(processes.begin(), processes.end(), process), processes.end());
 		}
 	}
+
+	clock.removeParticipant(allocationParticipant);
 }
 
 
+void ResourceManager::collectProcess(std::shared_ptr<Process> process) {
+	// Called on the core that finished it. Status snapshots and screens may still hold the process, the table
+	// only rebuilds its slot once their pointers are gone
+	memoryManager.deallocate(process->getID());
+	processesMasterList.retire(process);
+	processTable.release(process->getHandle());
+}
+
 void ResourceManager::startAllocationThread() {
+	clock.addParticipant(allocationParticipant);
 	allocationThread = std::thread(&ResourceManager::allocateAndScheduleProcesses, this);
 }
 
@@ -157,6 +162,10 @@ MemoryManager* ResourceManager::getMemoryManager()
 {
 	return &memoryManager;
 }
+ProcessTable* ResourceManager::getProcessTable()
+{
+	return &processTable;
+}
 
 // Scheduler test
 
@@ -164,6 +173,7 @@ void ResourceManager::startSchedulerTest() {
 	std::lock_guard<std::mutex> lock(mtx);
 	if (!schedulerTest) {
 		schedulerTest = true;
+		clock.addParticipant(testParticipant);
 		testThread = std::thread(&ResourceManager::schedulerTestLoop, this);
 	}
 }
@@ -185,20 +195,16 @@ void ResourceManager::schedulerTestLoop() {
 		schedulerCounter++;
 		int processID = schedulerCounter;
 		createProcess("process_test" + std::to_string(processID));
-		std::this_thread::sleep_for(std::chrono::duration<double>(configManager->getBatchProcessFrequency()));
+		clock.sleepFor(testParticipant, SimulationClock::toDuration(configManager->getBatchProcessFrequency()));
 	}
+
+	clock.removeParticipant(testParticipant);
 }
 
 void ResourceManager::displayStatus() {
 	std::lock_guard<std::mutex> lock(processMutex);
 
-	int coresUsed = 0;
-	const std::vector<std::unique_ptr<CoreWorker>>& cores = scheduler.getCoreWorkers();
-	for (const auto& core : cores) {
-		if (core->isAssignedProcess()) {
-			coresUsed++;
-		}
-	}
+	int coresUsed = scheduler.getBusyCoreCount();
 
 	int totalCores = configManager->getNumCPU();
 	int cpuUtilization = totalCores ? (coresUsed * 100 / totalCores) : 0;
@@ -209,7 +215,7 @@ void ResourceManager::displayStatus() {
 	std::cout << "--------------------------------------------\n";
 
 	std::cout << "Running processes:\n";
-	const std::vector<std::shared_ptr<Process>>& processes = scheduler.getProcesses();
+	std::vector<std::shared_ptr<Process>> processes = processesMasterList.getAll();
 	for (const auto& process : processes) {
 		if (!process->isFinished()) {
 			std::cout << std::left << std::setw(20) << process->getName()
@@ -230,14 +236,12 @@ void ResourceManager::displayStatus() {
 	}
 
 	std::cout << "\nFinished processes:\n";
-	for (const auto& process : processes) {
-		if (process->isFinished()) {
-			std::cout << std::left << std::setw(20) << process->getName()
-				<< std::left << std::setw(30) << process->getCreationTime()
-				<< "Core:   " << std::setw(15) << process->getCore()
-				<< std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-				<< process->getTotalInstructions() << "\n";
-		}
+	for (const auto& record : processesMasterList.getFinished()) {
+		std::cout << std::left << std::setw(20) << record.name
+			<< std::left << std::setw(30) << record.creationTime
+			<< "Core:   " << std::setw(15) << record.core
+			<< std::left << std::setw(1) << record.totalInstructions << " / "
+			<< record.totalInstructions << "\n";
 	}
 
 	std::cout << "--------------------------------------------\n";
@@ -255,7 +259,7 @@ void ResourceManager::displayProcessSmi() {
 	std::cout << "Running processes and memory usage: \n";
 	std::cout << "--------------------------------------------\n";
 
-	const std::vector<std::shared_ptr<Process>>& processes = scheduler.getProcesses();
+	std::vector<std::shared_ptr<Process>> processes = processesMasterList.getAll();
 	for (const auto& process : processes) {
 		if (!process->isFinished() && process->getCore() != -1) {
 			std::cout << std::left << std::setw(20) << process->getName()
@@ -267,11 +271,18 @@ void ResourceManager::displayProcessSmi() {
 
 void ResourceManager::displayVMStat() {
 	std::vector<long long> stats = getCoreStats();
+	std::vector<long long> preemptionStats = getPreemptionStats();
+	std::vector<long long> timingStats = getTimingStats();
+	std::vector<long long> tlbStats = getTLBStats();
 	int usedMemory = memoryManager.getUsedMemory();
 	int activeMemory = memoryManager.getActiveMemory();
 	int inactiveMemory = memoryManager.getInactiveMemory();
-	int pagedIn = memoryManager.pagingAllocator.getNumPagesPagedIn();
-	int pagedOut = memoryManager.pagingAllocator.getNumPagesPagedOut();
+	std::vector<int> pagingStats = memoryManager.getPagingStats();
+	int pageFaults = memoryManager.getNumPageFaults();
+	size_t pageTableBytes = memoryManager.getPageTableBytes();
+	std::vector<int> swapInStats = memoryManager.getSwapInStats();
+	std::vector<int> reclaimStats = memoryManager.getReclaimStats();
+	std::vector<int> watermarks = memoryManager.getWatermarks();
 
 	std::cout << configManager->getMaxOverallMemory() << " KB total memory\n";
 	std::cout << usedMemory << " KB used memory\n"; // Total used memory, including possible external fragmentation
@@ -280,19 +291,40 @@ void ResourceManager::displayVMStat() {
 	std::cout << stats[2] << " idle cpu ticks\n"; 
 	std::cout << stats[1] << " active cpu ticks\n";
 	std::cout << stats[0] << " total cpu ticks\n";
-	std::cout << pagedIn << " pages paged in\n";
-	std::cout << pagedOut << " pages paged out\n";
+	std::cout << pagingStats[0] << " pages paged in\n";
+	std::cout << pagingStats[1] << " pages paged out\n";
+	std::cout << pagingStats[2] << " pages read ahead\n";
+	std::cout << swapInStats[0] << " processes swapped in (" << swapInStats[1] << " by prefetch)\n";
+	std::cout << reclaimStats[0] << " background evictions";
+	if (watermarks[0] > 0) {
+		std::cout << " (watermarks " << watermarks[0] << "/" << watermarks[1] << " KB free)\n";
+	}
+	else {
+		std::cout << " (reclaim off)\n"; // A zero low watermark never wakes the reclaimer
+	}
+	std::cout << reclaimStats[1] << " allocations that evicted directly\n";
+	std::cout << pagingStats[3] << " dirty pages written to the backing store\n";
+	std::cout << pagingStats[4] << " clean pages dropped\n";
+	std::cout << pageTableBytes << " bytes of page tables (" << configManager->getPageTable() << ")\n";
+	// Only paging faults on pages, flat and buddy count the allocations that had to evict a whole process
+	if (configManager->getMemoryManagerAlgorithm() == "paging") {
+		std::cout << pageFaults << " page faults (" << configManager->getPageReplacement() << " replacement)\n";
+	}
+	else {
+		std::cout << pageFaults << " swap faults (allocations that evicted a process, " << configManager->getPageReplacement() << " replacement)\n";
+	}
+	std::cout << tlbStats[0] << " TLB hits\n";
+	std::cout << tlbStats[1] << " TLB misses\n";
+	std::cout << tlbStats[2] << " TLB flushes\n";
+	std::cout << preemptionStats[0] << " preemptions\n";
+	std::cout << (preemptionStats[0] ? preemptionStats[1] / preemptionStats[0] : 0) << " us avg preemption latency\n";
+	std::cout << timingStats[0] << " us avg response time\n";
+	std::cout << timingStats[1] << " us avg turnaround time\n";
 }
 
 
 int ResourceManager::getCPUUtilization() {
-	int coresUsed = 0;
-	const std::vector<std::unique_ptr<CoreWorker>>& cores = scheduler.getCoreWorkers();
-	for (const auto& core : cores) {
-		if (core->isAssignedProcess()) {
-			coresUsed++;
-		}
-	}
+	int coresUsed = scheduler.getBusyCoreCount();
 
 	int totalCores = configManager->getNumCPU();
 	int cpuUtilization = totalCores ? (coresUsed * 100 / totalCores) : 0;
@@ -323,6 +355,71 @@ std::vector<long long> ResourceManager::getCoreStats() {
 	return { cpuTicks, activeTicks, idleTicks };
 }
 
+std::vector<long long> ResourceManager::getPreemptionStats() {
+	const std::vector<std::unique_ptr<CoreWorker>>& cores = scheduler.getCoreWorkers();
+	long long preemptions = 0;
+	long long totalLatency = 0;
+
+	for (const auto& core : cores) {
+		std::vector<long long> stats = core->getPreemptionStats();
+		preemptions += stats[0];
+		totalLatency += stats[1];
+	}
+
+	return { preemptions, totalLatency };
+}
+
+std::vector<long long> ResourceManager::getTLBStats() {
+	const std::vector<std::unique_ptr<CoreWorker>>& cores = scheduler.getCoreWorkers();
+	long long hits = 0;
+	long long misses = 0;
+	long long flushes = 0;
+
+	for (const auto& core : cores) {
+		std::vector<long long> stats = core->getTLBStats();
+		hits += stats[0];
+		misses += stats[1];
+		flushes += stats[2];
+	}
+
+	return { hits, misses, flushes };
+}
+
+std::vector<long long> ResourceManager::getTimingStats() {
+	long long totalResponse = 0;
+	long long totalTurnaround = 0;
+	long long responded = 0;
+	long long completed = 0;
+
+	// Timestamps are atomics on each process, no process lock is needed to read them
+	for (const auto& process : processesMasterList.getAll()) {
+		long long response = process->getResponseTime();
+		long long turnaround = process->getTurnaroundTime();
+		if (response >= 0) {
+			totalResponse += response;
+			responded++;
+		}
+		if (turnaround >= 0) {
+			totalTurnaround += turnaround;
+			completed++;
+		}
+	}
+
+	// Collected processes only left their timestamps behind in the registry
+	for (const auto& record : processesMasterList.getFinished()) {
+		if (record.responseTime >= 0) {
+			totalResponse += record.responseTime;
+			responded++;
+		}
+		totalTurnaround += record.turnaroundTime;
+		completed++;
+	}
+
+	long long avgResponse = responded ? totalResponse / responded / 1000 : 0;
+	long long avgTurnaround = completed ? totalTurnaround / completed / 1000 : 0;
+	return { avgResponse, avgTurnaround };
+}
+
 void ResourceManager::saveReport() {
 	std::cout << "Saving report..." << std::endl;
 
@@ -334,15 +431,9 @@ void ResourceManager::saveReport() {
 
 	std::lock_guard<std::mutex> lock(processMutex);
 
-	int coresUsed = 0;
-	const std::vector<std::unique_ptr<CoreWorker>>& cores = scheduler.getCoreWorkers();
-	for (const auto& core : cores) {
-		if (core->isAssignedProcess()) {
-			coresUsed++;
-		}
-	}
+	int coresUsed = scheduler.getBusyCoreCount();
 
-	int totalCores = cores.size();
+	int totalCores = configManager->getNumCPU();
 	int cpuUtilization = totalCores ? (coresUsed * 100 / totalCores) : 0;
 
 	file << "CPU utilization: " << cpuUtilization << "%\n";
@@ -353,7 +444,8 @@ void ResourceManager::saveReport() {
 	file << "--------------------------------------------\n";
 
 	file << "Running processes:\n";
-	for (const auto& process : processesMasterList) {
+	std::vector<std::shared_ptr<Process>> processes = processesMasterList.getAll();
+	for (const auto& process : processes) {
 		if (!process->isFinished()) {
 			file << std::left << std::setw(20) << process->getName()
 				<< std::left << std::setw(30) << process->getCreationTime();
@@ -375,14 +467,12 @@ void ResourceManager::saveReport() {
 
 	file << "\nFinished processes:\n";
 
-	for (const auto& process : processesMasterList) {
-		if (process->isFinished()) {
-			file << std::left << std::setw(20) << process->getName()
-				<< std::left << std::setw(30) << process->getCreationTime()
-				<< "Core:   " << std::setw(15) << process->getCore()
-				<< std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-				<< process->getTotalInstructions() << "\n";
-		}
+	for (const auto& record : processesMasterList.getFinished()) {
+		file << std::left << std::setw(20) << record.name
+			<< std::left << std::setw(30) << record.creationTime
+			<< "Core:   " << std::setw(15) << record.core
+			<< std::left << std::setw(1) << record.totalInstructions << " / "
+			<< record.totalInstructions << "\n";
 	}
 
 	file << "--------------------------------------------\n";
@@ -391,7 +481,7 @@ void ResourceManager::saveReport() {
 }
 
 void ResourceManager::displayAllProcesses() {
-	const std::vector<std::shared_ptr<Process>>& processes = scheduler.getProcesses();
+	std::vector<std::shared_ptr<Process>> processes = processesMasterList.getAll();
 	std::cout << "=========================\n";
 	std::cout << "in display all processes\n";
 	for (auto& process : processes) {
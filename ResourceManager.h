@@ -4,6 +4,9 @@
 #include "Scheduler.h"
 #include "ConfigurationManager.h"
 #include "Process.h"
+#include "SimulationClock.h"
+#include "ProcessRegistry.h"
+#include "ProcessTable.h"
 
 #include <vector>
 #include <memory>
@@ -20,13 +23,14 @@ public:
 
     bool initialize(ConfigurationManager* newConfigManager); // Initialize the scheduler and the memory manager
 
-    std::shared_ptr<Process> createProcess(const std::string process_name);
+    std::shared_ptr<Process> createProcess(const std::string process_name); // Returns nullptr if the name is already taken
     bool processExists(std::string name); // Check if a process with the given name exists
     std::shared_ptr<Process> findProcessByName(const std::string name); // Returns a process by its name
     void allocateAndScheduleProcesses(); // Allocate memory for processes and schedule them
 
     Scheduler* getScheduler();
     MemoryManager* getMemoryManager();
+    ProcessTable* getProcessTable();
 
     // Scheduler test
     void startSchedulerTest();
@@ -46,12 +50,14 @@ public:
     void displayAllProcesses();
 private:
     ConfigurationManager* configManager;
+    SimulationClock clock; // Declared first so it outlives the threads that use it
+    ProcessTable processTable; // Owns every process, the lists below only hold pointers into it
+    ProcessRegistry processesMasterList; // Every created process, indexed by name and PID, shared with the Scheduler and outliving its cores
     MemoryManager memoryManager;
     Scheduler scheduler;
 
     bool running;
     std::vector<std::shared_ptr<Process>> processes;
-    std::vector<std::shared_ptr<Process>> processesMasterList;
     std::mutex processMutex;
     std::condition_variable processAdded;
 
@@ -60,13 +66,16 @@ private:
     int getRandomInt2N(int min, int max); // Randomizer for the process details wherein number = 2^n
 
     std::thread allocationThread;
+    SimulationClock::Participant allocationParticipant;
     void startAllocationThread();
     void stopAllocationThread();
+    void collectProcess(std::shared_ptr<Process> process); // Frees a finished process's memory and slot, keeping its record for the listings
 
     // Scheduler test
     int schedulerCounter = 0;
     std::atomic<bool> schedulerTest{ false };
     std::thread testThread;
+    SimulationClock::Participant testParticipant;
     std::mutex mtx;
 
     void schedulerTestLoop();
@@ -74,5 +83,8 @@ private:
     int getCPUUtilization();
     int getMemoryUtilization();
     std::vector<long long> getCoreStats();
+    std::vector<long long> getPreemptionStats();
+    std::vector<long long> getTimingStats(); // Average response and turnaround time in microseconds, over dispatched and finished processes
+    std::vector<long long> getTLBStats(); // TLB hits, misses and flushes summed over the cores
     int getInactiveMemory();
 };
@@ -6,9 +6,10 @@
 #include <windows.h>
 #include <iomanip>
 #include <optional>
+#include <stdexcept>
 
 
-Scheduler::Scheduler() : running(false) {}
+Scheduler::Scheduler() : clock(nullptr), dispatchPending(false), running(false) {}
 
 Scheduler::~Scheduler() {
     stop();
@@ -20,39 +21,101 @@ Scheduler::~Scheduler() {
     }
 }
 
-void Scheduler::addProcess(const Process& process) {
-    std::lock_guard<std::mutex> lock(processMutex);
-    auto newProcess = std::make_shared<Process>(process);
-    processes.push_back(newProcess);
+void Scheduler::addProcess(std::shared_ptr<Process> process) {
+    process->markArrived(clock->now());
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    readyQueue.push(newProcess);
+    enqueueReady(process, readyQueue);
+    notifyDispatch();
 }
 
+void Scheduler::resumeProcess(std::shared_ptr<Process> process) {
+    // Otherwise not behind everything that arrived while it was blocked, its pages would be evicted again before it ran
+    enqueueReady(process, resumeAtTail ? readyQueue : resumedQueue);
+    notifyDispatch();
+}
 
-std::shared_ptr<Process> Scheduler::getProcessByName(const std::string name) {
-    std::lock_guard<std::mutex> lock(processMutex);
-    for (auto& process : processes) {
-        if (process->getName() == name) {
-            return process;
-        }
+void Scheduler::setPageFaultHandler(std::function<bool(const Process&, TLB&)> walkPageTable, std::function<void(std::shared_ptr<Process>)> onPageFault,
+    std::function<void(int pid, int page)> onPageDirtied) {
+    for (auto& core : cores) {
+        core->setPageFaultHandler(walkPageTable, onPageFault, onPageDirtied);
     }
-    return nullptr;
 }
 
-std::shared_ptr<Process> Scheduler::getProcessByID(int pid) {
-    std::lock_guard<std::mutex> lock(processMutex);
-    for (auto& process : processes) {
-        if (process->getID() == pid) {
-            return process;
-        }
+void Scheduler::setSwapInHandler(std::function<void(std::shared_ptr<Process>)> onSwappedOut, std::function<void(std::shared_ptr<Process>)> onPrefetch) {
+    for (auto& core : cores) {
+        core->setSwapInHandler(onSwappedOut);
+    }
+    prefetchHint = onPrefetch;
+}
+
+void Scheduler::setFinishHandler(std::function<void(std::shared_ptr<Process>)> onFinished) {
+    finishHandler = onFinished;
+}
+
+void Scheduler::prefetchAhead(const std::shared_ptr<Process>& process) {
+    if (prefetchHint) {
+        prefetchHint(process);
+    }
+}
+
+void Scheduler::invalidateTLBEntry(int pid, int page) {
+    for (auto& core : cores) {
+        core->invalidateTLBEntry(pid, page);
+    }
+}
+
+void Scheduler::notifyDispatch() {
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        dispatchPending = true;
     }
-    return nullptr;
+    clock->wake(clockParticipant);
+    dispatchCondition.notify_one();
 }
 
-bool Scheduler::initialize(ConfigurationManager* newConfigManager) {
+void Scheduler::enqueueReady(std::shared_ptr<Process> process, ReadyQueue& queue) {
+    // A process swapped out while it waited stays SWAPPED, so whichever core runs it next swaps it back in.
+    // A sleeping process stays WAITING until its sleep runs out on a core
+    Process::State state = process->getState();
+    while (state != Process::State::SWAPPED && state != Process::State::WAITING && !process->transition(state, Process::State::READY)) {
+        state = process->getState();
+    }
+    while (!queue.push(process)) {
+        std::this_thread::yield(); // Queue is full, wait for the scheduler to drain it
+    }
+}
+
+void Scheduler::handleProcessCompletion(std::shared_ptr<Process> process) {
+    if (process->getState() == Process::State::BLOCKED) {
+        // Page fault, the MemoryManager hands the process back through resumeProcess
+    }
+    else if (!process->isFinished()) {
+        // Quantum expired, requeue the process
+        enqueueReady(process, readyQueue);
+    }
+    else if (finishHandler) {
+        finishHandler(process); // Its core has let go of it and no queue holds it
+    }
+
+    // The core that called this is free again
+    notifyDispatch();
+}
+
+
+std::shared_ptr<Process> Scheduler::getProcessByName(const std::string name) {
+    return processes->findByName(name);
+}
+
+std::shared_ptr<Process> Scheduler::getProcessByID(int pid) {
+    return processes->findByID(pid);
+}
+
+bool Scheduler::initialize(ConfigurationManager* newConfigManager, SimulationClock* newClock, ProcessRegistry* newRegistry) {
     try {
         configManager = newConfigManager;
+        clock = newClock;
+        processes = newRegistry;
+        selectPolicy();
         initializeCoreWorkers();
         running = true;
         run();
@@ -65,334 +128,384 @@ bool Scheduler::initialize(ConfigurationManager* newConfigManager) {
 }
 
 void Scheduler::initializeCoreWorkers() {
+    idleCores = std::make_unique<CoreBitmap>(configManager->getNumCPU());
+
     for (int i = 0; i < configManager->getNumCPU(); i++) {
-        if (configManager->getSchedulerAlgorithm() == "rr") {
-            cores.emplace_back(std::make_unique<CoreWorker>(i + 1, configManager->getDelayPerExec(), configManager->getQuantumCycles()));
-            cores.back()->start();
+        auto tlb = std::make_unique<TLB>(configManager->getTLBEntries(), configManager->getTLBAssociativity(), configManager->isTLBASIDTagged());
+        cores.emplace_back(std::make_unique<CoreWorker>(i + 1, clock, idleCores.get(), std::move(tlb), configManager->getDelayPerExec(), coreQuantum));
+
+        // Every core reports back when it releases a process so the scheduler can dispatch again
+        cores.back()->setProcessCompletionCallback([this](std::shared_ptr<Process> completedProcess) {
+            handleProcessCompletion(completedProcess);
+            });
+    }
+
+    // Each core may steal from every other core's run queue
+    for (auto& core : cores) {
+        std::vector<CoreWorker*> peers;
+        for (auto& peer : cores) {
+            if (peer != core) {
+                peers.push_back(peer.get());
+            }
         }
+        core->setPeers(peers);
+    }
 
+    for (auto& core : cores) {
+        core->start();
+    }
+}
+
+struct Scheduler::FCFSPolicy {
+    static const bool usesBoostTimer = false;
+    static void prepare(Scheduler& scheduler) { scheduler.coreQuantum = 0; }
+    static void dispatch(Scheduler& scheduler) { scheduler.scheduleFCFS(); }
+};
+
+struct Scheduler::NonPreemptiveSJFPolicy {
+    static const bool usesBoostTimer = false;
+    static void prepare(Scheduler& scheduler) { scheduler.coreQuantum = 0; }
+    static void dispatch(Scheduler& scheduler) { scheduler.scheduleNonPreemptiveSJF(); }
+};
+
+struct Scheduler::PreemptiveSJFPolicy {
+    static const bool usesBoostTimer = false;
+    static void prepare(Scheduler& scheduler) { scheduler.coreQuantum = 0; }
+    static void dispatch(Scheduler& scheduler) { scheduler.schedulePreemptiveSJF(); }
+};
+
+struct Scheduler::RRPolicy {
+    static const bool usesBoostTimer = false;
+    static void prepare(Scheduler& scheduler) {
+        scheduler.coreQuantum = scheduler.configManager->getQuantumCycles();
+        scheduler.resumeAtTail = true;
+    }
+    static void dispatch(Scheduler& scheduler) { scheduler.scheduleRR(); }
+};
+
+struct Scheduler::MLFQPolicy {
+    static const bool usesBoostTimer = true;
+    static void prepare(Scheduler& scheduler) {
+        // The quantum is set per dispatch from the process's level, the top level's is the default
+        scheduler.coreQuantum = static_cast<float>(scheduler.configManager->getMLFQQuantumCycles(0));
+        scheduler.mlfqQueues.resize(scheduler.configManager->getMLFQLevels());
+        scheduler.nextBoost = scheduler.clock->now() + scheduler.getBoostPeriod();
+    }
+    static void dispatch(Scheduler& scheduler) { scheduler.scheduleMLFQ(); }
+};
+
+template <typename Policy>
+void Scheduler::usePolicy() {
+    Policy::prepare(*this);
+    schedulerLoop = &Scheduler::dispatchLoop<Policy>;
+}
+
+void Scheduler::selectPolicy() {
+    // The only place the algorithm name is compared
+    const std::string& algorithm = configManager->getSchedulerAlgorithm();
+    if (algorithm == "fcfs") {
+        usePolicy<FCFSPolicy>();
+    }
+    else if (algorithm == "sjf") {
+        if (configManager->isPreemptive()) {
+            usePolicy<PreemptiveSJFPolicy>();
+        }
         else {
-            cores.emplace_back(std::make_unique<CoreWorker>(i + 1, configManager->getDelayPerExec()));
-            cores.back()->start();
+            usePolicy<NonPreemptiveSJFPolicy>();
         }
-
+    }
+    else if (algorithm == "rr") {
+        usePolicy<RRPolicy>();
+    }
+    else if (algorithm == "mlfq") {
+        usePolicy<MLFQPolicy>();
+    }
+    else {
+        throw std::runtime_error("Unknown scheduler algorithm: " + algorithm);
     }
 }
 
 void Scheduler::run() {
-    schedulerThread = std::thread(&Scheduler::schedulerLoop, this);
+    clock->addParticipant(clockParticipant);
+    schedulerThread = std::thread(schedulerLoop, this);
 }
 
-void Scheduler::schedulerLoop() {
+template <typename Policy>
+void Scheduler::dispatchLoop() {
     while (running) {
-        if (configManager->getSchedulerAlgorithm() == "fcfs") {
-            scheduleFCFS();
-        }
-        else if (configManager->getSchedulerAlgorithm() == "sjf") {
-            if (configManager->isPreemptive()) {
-				schedulePreemptiveSJF();
-			}
-			else {
-				scheduleNonPreemptiveSJF();
-			}
+        // Block until a dispatch event arrives instead of polling the ready queue
+        {
+            std::unique_lock<std::mutex> lock(dispatchMutex);
+            if (Policy::usesBoostTimer && hasDemotedProcesses()) {
+                // Also wake for the next priority boost. Without a demoted process it would do nothing, and on the
+                // virtual clock its deadline alone would keep moving time forward while everything else is idle
+                clock->waitUntil(clockParticipant, lock, dispatchCondition, nextBoost, [this] { return !running || dispatchPending; });
+            }
+            else {
+                clock->wait(clockParticipant, lock, dispatchCondition, [this] { return !running || dispatchPending; });
+            }
+            dispatchPending = false;
         }
-        else if (configManager->getSchedulerAlgorithm() == "rr") {
-            scheduleRR();
+
+        if (!running) {
+            break;
         }
 
-        std::this_thread::sleep_for(std::chrono::duration<float>(configManager->getDelayPerExec()));
+        Policy::dispatch(*this);
     }
+
+    clock->removeParticipant(clockParticipant);
 }
 
 void Scheduler::stop() {
-    running = false;
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        running = false;
+    }
+    if (clock) {
+        clock->wake(clockParticipant); // Not set before initialize
+    }
+    dispatchCondition.notify_all();
 }
 
 const std::vector<std::unique_ptr<CoreWorker>>& Scheduler::getCores() const {
     return cores;
 }
 
-void Scheduler::displayStatus() {
-    // TODO: Remove this and integrate to Resource Manager
-    std::lock_guard<std::mutex> lock(processMutex);
+int Scheduler::getAvailableCoreWorkerID() {
+    return idleCores->findIdle();
+}
+
+int Scheduler::getBusyCoreCount() const {
+    return idleCores ? idleCores->countBusy() : 0;
+}
 
-    int coresUsed = 0;
-    for (const auto& core : cores) {
-        if (core->isAssignedProcess()) {
-            coresUsed++;
+void Scheduler::drainResumedToOverflow() {
+    std::shared_ptr<Process> process;
+    while (resumedQueue.pop(process)) {
+        auto position = readyOverflow.begin();
+        while (position != readyOverflow.end() && (*position)->getArrivalTime() <= process->getArrivalTime()) {
+            ++position;
         }
+        readyOverflow.insert(position, process);
     }
+}
 
-    int totalCores = cores.size();
-    int cpuUtilization = totalCores ? (coresUsed * 100 / totalCores) : 0;
-
-    std::cout << "CPU utilization: " << cpuUtilization << "%\n";
-    std::cout << "Cores used: " << coresUsed << "\n";
-    std::cout << "Cores available: " << totalCores - coresUsed << "\n";
-    std::cout << "--------------------------------------------\n";
+void Scheduler::distributeToRunQueues() {
+    // Resumed processes go ahead of the ready queue, everything in it arrived or was requeued after they were dispatched
+    drainResumedToOverflow();
+
+    while (!readyOverflow.empty() || !readyQueue.empty()) {
+        // Pick the least loaded core, an idle core has a load of 0
+        CoreWorker* target = nullptr;
+        int targetLoad = MAX_CORE_LOAD;
+        for (auto& core : cores) {
+            int load = core->getLoad();
+            if (load < targetLoad) {
+                target = core.get();
+                targetLoad = load;
+            }
+        }
 
-    std::cout << "Running processes:\n";
+        if (!target) {
+            break; // Every run queue is full, cores will pull more once they release a process
+        }
 
-    for (const auto& process : processes) {
-        if (!process->isFinished()) {
-            std::cout << std::left << std::setw(20) << process->getName()
-                << std::left << std::setw(30) << process->getCreationTime();
+        // Processes left over from an earlier pass go first so they keep their place
+        std::shared_ptr<Process> process;
+        if (!readyOverflow.empty()) {
+            process = readyOverflow.front();
+            readyOverflow.pop_front();
+        }
+        else if (!readyQueue.pop(process)) {
+            break;
+        }
 
-            // Check if the process has been assigned a core
-            if (process->getCore() != -1) {
-                std::cout << "Core:   " << std::setw(15) << process->getCore();
-                std::cout << std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-                    << process->getTotalInstructions() << "\n";
-            }
-            else {
-                std::cout << "Core:   " << std::setw(15) << " "; // Adjust the width to maintain alignment
-                std::cout << std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-                    << process->getTotalInstructions() << "\n";
+        if (!target->enqueueProcess(process)) {
+            // Only this thread drains the ready queue, so waiting for room here would never end. The state
+            // is left alone, the process is still READY unless the memory manager swapped it out meanwhile
+            if (!readyQueue.push(process)) {
+                readyOverflow.push_front(process);
             }
+            break;
         }
-    }
-
-    std::cout << "\nFinished processes:\n";
-
-    for (const auto& process : processes) {
-        if (process->isFinished()) {
-            std::cout << std::left << std::setw(20) << process->getName()
-                << std::left << std::setw(30) << process->getCreationTime()
-                << "Core:   " << std::setw(15) << process->getCore()
-                << std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-                << process->getTotalInstructions() << "\n";
+        if (targetLoad > 0) {
+            prefetchAhead(process); // Queued behind a running process, there is time to bring it in
         }
     }
-
-    std::cout << "--------------------------------------------\n";
 }
 
+void Scheduler::scheduleFCFS() {
+    // Processes keep arrival order within each core's run queue, idle cores steal from busy ones
+    distributeToRunQueues();
+}
 
-void Scheduler::saveReport() {
-    // TODO: Remove this and integrate to Resource Manager
-    std::cout << "Saving report..." << std::endl;
-
-    std::ofstream file("csopesy-log.txt");
-    if (!file) {
-        std::cerr << "Error opening file." << std::endl;
-        return;
+void Scheduler::drainReadyQueueToSJF(bool byRemaining) {
+    // Resumed processes are keyed like the rest, the heap puts them back where they were
+    std::shared_ptr<Process> process;
+    while (resumedQueue.pop(process) || readyQueue.pop(process)) {
+        int key = byRemaining ? process->getRemainingInstructions() : process->getTotalInstructions();
+        sjfQueue.push(process, key);
     }
+}
 
-    std::lock_guard<std::mutex> lock(processMutex);
+void Scheduler::scheduleNonPreemptiveSJF() {
+    drainReadyQueueToSJF(false);
 
-    int coresUsed = 0;
-    for (const auto& core : cores) {
-        if (core->isAssignedProcess()) {
-            coresUsed++;
+    // Assign the shortest jobs (by total instructions) to available cores
+    while (!sjfQueue.empty()) {
+        auto coreID = getAvailableCoreWorkerID();
+        if (coreID == 0) {
+            break; // No available core, the rest stay in the heap
         }
+
+        auto process = sjfQueue.pop();
+        process->setCore(coreID);
+        cores[coreID - 1]->setProcess(process);
     }
 
-    int totalCores = cores.size();
-    int cpuUtilization = totalCores ? (coresUsed * 100 / totalCores) : 0;
+    if (!sjfQueue.empty()) {
+        prefetchAhead(sjfQueue.top()); // Next to be dispatched once a core frees up
+    }
+}
 
-    file << "CPU utilization: " << cpuUtilization << "%\n";
-    file << "Cores used: " << coresUsed << "\n";
-    file << "Cores available: " << totalCores - coresUsed << "\n";
-    file << "--------------------------------------------\n";
+void Scheduler::schedulePreemptiveSJF() {
+    drainReadyQueueToSJF(true);
 
-    file << "Running processes:\n";
+    while (!sjfQueue.empty()) {
+        auto coreID = getAvailableCoreWorkerID(); // Get the first available core
 
-    for (const auto& process : processes) {
-        if (!process->isFinished()) {
-            file << std::left << std::setw(20) << process->getName()
-                << std::left << std::setw(30) << process->getCreationTime();
+        if (coreID > 0) { // There is an available core
+            auto process = sjfQueue.pop();
+            process->setCore(coreID);
+            cores[coreID - 1]->setProcess(process);
+            continue;
+        }
 
-            // Check if the process has been assigned a core
-            if (process->getCore() != -1) {
-                file << "Core:   " << std::setw(15) << process->getCore();
-                file << std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-                    << process->getTotalInstructions() << "\n";
+        // No available core, preempt the running process with the most remaining instructions if the shortest waiting one beats it
+        CoreWorker* victimCore = nullptr;
+        int victimRemaining = 0;
+        for (auto& core : cores) {
+            if (core->isPreemptionPending()) {
+                continue; // Already handing its process back
             }
-            else {
-                file << "Core:   " << std::setw(15) << " "; // Adjust the width to maintain alignment
-                file << std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-                    << process->getTotalInstructions() << "\n";
+            auto runningProcess = core->getCurrentProcess();
+            if (runningProcess && runningProcess->getRemainingInstructions() > victimRemaining) {
+                victimRemaining = runningProcess->getRemainingInstructions();
+                victimCore = core.get();
             }
         }
-    }
 
-    file << "\nFinished processes:\n";
-
-    for (const auto& process : processes) {
-        if (process->isFinished()) {
-            file << std::left << std::setw(20) << process->getName()
-                << std::left << std::setw(30) << process->getCreationTime()
-                << "Core:   " << std::setw(15) << process->getCore()
-                << std::left << std::setw(1) << process->getCurrentInstruction() << " / "
-                << process->getTotalInstructions() << "\n";
+        if (!victimCore || victimRemaining <= sjfQueue.topKey()) {
+            prefetchAhead(sjfQueue.top()); // Next to be dispatched once a core frees up
+            break; // No preemption possible, the rest keep waiting
         }
-    }
 
-    file << "--------------------------------------------\n";
+        // The core hands the victim back through the completion callback, which triggers another pass
+        // that requeues it and dispatches the shortest job to the freed core
+        victimCore->requestPreemption();
+        break;
+    }
+}
 
-    std::cout << "Report saved at csopesy-log.txt!" << std::endl;
+void Scheduler::scheduleRR() {
+    // Requeueing after a quantum is handled by handleProcessCompletion, which sends the process to the back of the global queue
+    distributeToRunQueues();
 }
 
-int Scheduler::getAvailableCoreWorkerID() {
-    for (auto& core : cores) {
-        if (core->isAvailable()) {
-            return core->getID();
-        }
+void Scheduler::scheduleMLFQ() {
+    int lowestLevel = static_cast<int>(mlfqQueues.size()) - 1;
+
+    if (clock->now() >= nextBoost) {
+        boostMLFQ();
     }
-    return 0;
-}
 
-void Scheduler::scheduleFCFS() {
-    while (running) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (!readyQueue.empty()) {
+    // Processes back from a page fault go to the front of their level in the order they resumed, they had not
+    // used up their quantum
+    std::shared_ptr<Process> process;
+    std::vector<std::shared_ptr<Process>> resumed;
+    while (resumedQueue.pop(process)) {
+        resumed.push_back(process);
+    }
+    for (auto it = resumed.rbegin(); it != resumed.rend(); ++it) {
+        mlfqQueues[(*it)->getPriorityLevel()].push_front(*it);
+    }
 
-            auto process = readyQueue.front();
-            readyQueue.pop();
+    // New arrivals enter the top level. A process that comes back still holding its core used up its
+    // whole quantum and drops a level; a preempted one had its core cleared and keeps its level.
+    while (readyQueue.pop(process)) {
+        if (process->getCore() != -1 && process->getPriorityLevel() < lowestLevel) {
+            process->setPriorityLevel(process->getPriorityLevel() + 1);
+        }
+        mlfqQueues[process->getPriorityLevel()].push_back(process);
+    }
 
+    for (int level = 0; level <= lowestLevel; level++) {
+        auto& queue = mlfqQueues[level];
+        while (!queue.empty()) {
             auto coreID = getAvailableCoreWorkerID();
-
             if (coreID > 0) {
+                process = queue.front();
+                queue.pop_front();
                 process->setCore(coreID);
-                cores[coreID - 1]->setProcess(process);
+                cores[coreID - 1]->setProcess(process, configManager->getMLFQQuantumCycles(level));
+                continue;
             }
 
-            else {
-                // No available core, put the process back at the front of the queue
-                std::queue<std::shared_ptr<Process>> tempQueue;
-                tempQueue.push(process);
-                while (!readyQueue.empty()) {
-                    tempQueue.push(readyQueue.front());
-                    readyQueue.pop();
+            // No available core, preempt a process running at a lower priority level than this one
+            for (auto& core : cores) {
+                auto runningProcess = core->getCurrentProcess();
+                if (runningProcess && runningProcess->getPriorityLevel() > level && core->requestPreemption()) {
+                    break; // The handoff triggers another pass that dispatches to the freed core
                 }
-                readyQueue = tempQueue;
             }
+            prefetchAhead(queue.front()); // Next to be dispatched once a core frees up
+            return;
         }
     }
 }
 
-void Scheduler::scheduleNonPreemptiveSJF() {
-    while (running) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (!readyQueue.empty()) {
-
-            // Move processes to a vector for sorting
-            std::vector<std::shared_ptr<Process>> sortedProcesses;
-            while (!readyQueue.empty()) {
-                sortedProcesses.push_back(readyQueue.front());
-                readyQueue.pop();
-            }
-
-            // Sort processes by total instructions (burst time)
-            std::sort(sortedProcesses.begin(), sortedProcesses.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
-                return a->getTotalInstructions() < b->getTotalInstructions();
-                });
-
-            // Assign sorted processes to available cores
-            for (auto& process : sortedProcesses) {
-                auto coreID = getAvailableCoreWorkerID();
-                if (coreID > 0) {
-                    process->setCore(coreID);
-                    cores[coreID - 1]->setProcess(process);
-                }
-                else {
-                    readyQueue.push(process); // Put back in the ready queue if no core is available
-                }
-            }
+void Scheduler::boostMLFQ() {
+    for (size_t level = 1; level < mlfqQueues.size(); level++) {
+        for (auto& process : mlfqQueues[level]) {
+            process->setPriorityLevel(0);
+            mlfqQueues[0].push_back(process);
         }
+        mlfqQueues[level].clear();
     }
-}
 
-void Scheduler::schedulePreemptiveSJF() {
-    while (running) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (!readyQueue.empty()) {
-
-            // Move all processes from readyQueue to sortedProcesses vector
-            std::vector<std::shared_ptr<Process>> sortedProcesses;
-            while (!readyQueue.empty()) {
-                sortedProcesses.push_back(readyQueue.front());
-                readyQueue.pop();
-            }
-
-            // Sort the processes by remaining instructions (Shortest Job First)
-            std::sort(sortedProcesses.begin(), sortedProcesses.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
-                return a->getRemainingInstructions() < b->getRemainingInstructions();
-                });
-
-            // Try to assign sorted processes to available cores or preempt if necessary
-            for (auto& process : sortedProcesses) {
-                auto coreID = getAvailableCoreWorkerID(); // Get the first available core
-
-                if (coreID > 0) { // There is an available core
-                    process->setCore(coreID);
-                    cores[coreID - 1]->setProcess(process);
-                }
-
-                else { // No available core
-                    bool preempted = false;
-                    for (auto& core : cores) {
-                        auto runningProcess = core->getCurrentProcess();
-                        if (runningProcess && runningProcess->getRemainingInstructions() > process->getRemainingInstructions()) {
-                            
-                            // Preempt the current process
-                            readyQueue.push(runningProcess); // Push the running process back to the ready queue
-                            process->setCore(core->getID()); // Assign the new process to the core
-                            core->setProcess(process); 
-                            preempted = true;
-                            break;
-                        }
-                    }
-
-                    if (!preempted) {
-                        readyQueue.push(process); // Put back in the ready queue if no preemption occurred
-                    }
-                }
-            }
+    // Running processes are boosted too, so their quantum expiry demotes them from the top level only
+    for (auto& core : cores) {
+        auto runningProcess = core->getCurrentProcess();
+        if (runningProcess) {
+            runningProcess->setPriorityLevel(0);
         }
     }
-}
 
+    nextBoost = clock->now() + getBoostPeriod();
+}
 
-
-
-void Scheduler::scheduleRR() {
-    while (running) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (!readyQueue.empty()) {
-            auto process = readyQueue.front();
-            readyQueue.pop();
-
-            auto coreID = getAvailableCoreWorkerID();
-
-            if (coreID > 0) {
-                process->setCore(coreID);
-                cores[coreID - 1]->setProcess(process);
-
-                // Use a lambda function to handle requeueing the process after execution
-                cores[coreID - 1]->setProcessCompletionCallback([this](std::shared_ptr<Process> completedProcess) {
-                    if (!completedProcess->isFinished()) {
-                        std::lock_guard<std::mutex> queueLock(this->queueMutex);
-                        this->readyQueue.push(completedProcess);
-                    }
-                    else {
-                        std::lock_guard<std::mutex> processLock(this->processMutex);
-                        this->finishedProcesses.push_back(completedProcess);
-                    }
-                    });
-            }
-            else {
-                // No available core, put the process back at the front of the queue
-                readyQueue.push(process);
-            }
+bool Scheduler::hasDemotedProcesses() {
+    for (size_t level = 1; level < mlfqQueues.size(); level++) {
+        if (!mlfqQueues[level].empty()) {
+            return true;
         }
     }
+    for (auto& core : cores) {
+        auto runningProcess = core->getCurrentProcess();
+        if (runningProcess && runningProcess->getPriorityLevel() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::chrono::nanoseconds Scheduler::getBoostPeriod() {
+    // The boost interval is given in CPU cycles, one cycle lasts delay-per-exec
+    auto period = SimulationClock::toDuration(configManager->getMLFQBoostCycles() * configManager->getDelayPerExec());
+    return std::max<std::chrono::nanoseconds>(period, std::chrono::milliseconds(1));
 }
 
 const std::vector<std::unique_ptr<CoreWorker>>& Scheduler::getCoreWorkers() const {
     return cores;
 }
-
-const std::vector<std::shared_ptr<Process>>& Scheduler::getProcesses() const {
-    return processes;
-}
\ No newline at end of file
@@ -1,16 +1,24 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <chrono>
 #include <memory>
-#include <queue>
 #include <functional>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <windows.h>
 
 #include "Process.h"
 #include "ConfigurationManager.h"
 #include "CoreWorker.h"
+#include "ReadyQueue.h"
+#include "IndexedProcessQueue.h"
+#include "SimulationClock.h"
+#include "CoreBitmap.h"
+#include "ProcessRegistry.h"
 
 class Scheduler
 {
@@ -18,42 +26,84 @@ public:
     Scheduler();
     ~Scheduler();
 
-    void addProcess(const Process& process); // Add a process to the ready queue
+    void addProcess(std::shared_ptr<Process> process); // Add a process to the ready queue, the Scheduler shares the caller's copy
+    void resumeProcess(std::shared_ptr<Process> process); // Requeue a process once the page it faulted on is resident
     std::shared_ptr<Process> getProcessByName(const std::string name);
     std::shared_ptr<Process> getProcessByID(int pid);
 
-    bool initialize(ConfigurationManager* newConfigManager); // Initialize the scheduler with a configuration manager
+    bool initialize(ConfigurationManager* newConfigManager, SimulationClock* newClock, ProcessRegistry* newRegistry); // Initialize the scheduler with a configuration manager, the shared clock and the caller's process registry
     void run(); // Start the scheduler
     void stop();
     const std::vector<std::unique_ptr<CoreWorker>>& getCores() const; 
+    int getBusyCoreCount() const; // Lock-free count of cores running a process
+    void setPageFaultHandler(std::function<bool(const Process&, TLB&)> walkPageTable, std::function<void(std::shared_ptr<Process>)> onPageFault,
+        std::function<void(int pid, int page)> onPageDirtied); // Installed on every core
+    void invalidateTLBEntry(int pid, int page); // Shoot the translation down on every core
+    void setSwapInHandler(std::function<void(std::shared_ptr<Process>)> onSwappedOut, std::function<void(std::shared_ptr<Process>)> onPrefetch); // Installed before the first process is added
+    void setFinishHandler(std::function<void(std::shared_ptr<Process>)> onFinished); // Called once a finished process is off its core, installed before the first process is added
 
-    void displayStatus();
-    void saveReport(); 
-
-    // Access to core workers and prcesses
+    // Access to core workers
     const std::vector<std::unique_ptr<CoreWorker>>& getCoreWorkers() const;
-    const std::vector<std::shared_ptr<Process>>& getProcesses() const;
 private:
     ConfigurationManager* configManager;
+    SimulationClock* clock;
+    SimulationClock::Participant clockParticipant;
 
     std::vector<std::unique_ptr<CoreWorker>> cores; // All cores
-    std::vector<std::shared_ptr<Process>> processes; // All processes regardless of state
-    std::queue<std::shared_ptr<Process>> readyQueue; // All processes ready to go once a thread yields
-    std::vector<std::shared_ptr<Process>> finishedProcesses; // Add finished processes here
-    std::mutex processMutex; // Protects access to the processes vector
-    std::mutex queueMutex;   // Protects access to the readyQueue
+    std::unique_ptr<CoreBitmap> idleCores; // One bit per core, set while the core has no process assigned
+    ProcessRegistry* processes; // Owned by the ResourceManager, live processes indexed by name and PID
+    ReadyQueue readyQueue; // All processes ready to go once a thread yields (lock-free, shared by producers and the scheduler)
+    ReadyQueue resumedQueue; // Processes back from a page fault or swap-in, drained ahead of the ready queue so they keep their place
+    std::deque<std::shared_ptr<Process>> readyOverflow; // Popped processes no core took back while the ready queue was full, and resumed ones by arrival, only touched by the scheduler thread
+    IndexedProcessQueue sjfQueue; // Waiting processes ordered by burst for SJF, only touched by the scheduler thread
+    std::vector<std::deque<std::shared_ptr<Process>>> mlfqQueues; // One FIFO per MLFQ level, only touched by the scheduler thread
+    std::chrono::nanoseconds nextBoost; // Simulated time when MLFQ next moves every process back to the top level
+    std::mutex dispatchMutex; // Guards dispatchPending for the condition variable only, never held while dispatching
+    std::condition_variable dispatchCondition; // Wakes the scheduler thread when there is something to dispatch
+    bool dispatchPending; // Set by dispatch events (new process, core freed, quantum expiry)
 
-    bool running;
+    std::atomic<bool> running;
+    std::function<void(std::shared_ptr<Process>)> prefetchHint; // Asks the memory manager to bring a process in before a core reaches it
+    std::function<void(std::shared_ptr<Process>)> finishHandler; // Hands finished processes back to be collected
 
     void initializeCoreWorkers(); // Initialize the cores
     int getAvailableCoreWorkerID();
+    void drainReadyQueueToSJF(bool byRemaining); // Move new arrivals into sjfQueue keyed by total or remaining instructions
+    void distributeToRunQueues(); // Hand ready processes to the least loaded cores' local run queues
+    void notifyDispatch(); // Signal the scheduler thread that a dispatch pass is needed
+    void enqueueReady(std::shared_ptr<Process> process, ReadyQueue& queue); // Push to the ready or resumed queue, yielding while it is full
+    void drainResumedToOverflow(); // Slot resumed processes into readyOverflow by arrival time
+    void handleProcessCompletion(std::shared_ptr<Process> process); // Called by a core once it releases its process
+    void prefetchAhead(const std::shared_ptr<Process>& process); // Hint for a process that is next in line but not yet on a core
 
+    // Dispatch passes, called by schedulerLoop after each wakeup
     void scheduleFCFS();
     void scheduleNonPreemptiveSJF();
     void schedulePreemptiveSJF();
     void scheduleRR();
+    void scheduleMLFQ();
+    void boostMLFQ(); // Move every process back to the top MLFQ level so long jobs do not starve
+    bool hasDemotedProcesses(); // True if a queued or running process sits below the top MLFQ level
+    std::chrono::nanoseconds getBoostPeriod();
+
+    static const int MAX_CORE_LOAD = 3; // Running process plus queued processes a core may hold
+
+    // Scheduling policies. The dispatch loop is instantiated once per policy and selected in initialize,
+    // so the loop itself has no string comparisons or virtual calls.
+    struct FCFSPolicy;
+    struct NonPreemptiveSJFPolicy;
+    struct PreemptiveSJFPolicy;
+    struct RRPolicy;
+    struct MLFQPolicy;
+
+    void (Scheduler::*schedulerLoop)() = nullptr; // Main loop for the scheduler, specialized for the configured policy
+    float coreQuantum = 0; // Quantum slice the cores are created with, 0 runs processes to completion
+    bool resumeAtTail = false; // Round robin requeues a process back from a page fault behind the rest, like a quantum expiry
+
+    void selectPolicy(); // Pick the policy from the configuration
+    template <typename Policy> void usePolicy();
+    template <typename Policy> void dispatchLoop();
 
     bool isTestRunning;
     std::thread schedulerThread;
-    void schedulerLoop(); // Main loop for the scheduler
 };
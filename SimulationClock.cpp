@@ -0,0 +1,155 @@
+#include "SimulationClock.h"
+
+#include <thread>
+#include <algorithm>
+
+const long long SimulationClock::DEFAULT_TICK_NANOSECONDS;
+
+SimulationClock::SimulationClock()
+    : virtualTime(false), startTime(std::chrono::steady_clock::now()), tickLength(DEFAULT_TICK_NANOSECONDS), currentTime(0), busyParticipants(0) {}
+
+void SimulationClock::initialize(ConfigurationManager* configManager) {
+    virtualTime = configManager->getSimulationMode() == "virtual";
+    startTime = std::chrono::steady_clock::now();
+    long long delay = toDuration(configManager->getDelayPerExec()).count();
+    tickLength = delay > 0 ? delay : DEFAULT_TICK_NANOSECONDS;
+    currentTime = 0;
+}
+
+bool SimulationClock::isVirtual() const {
+    return virtualTime;
+}
+
+std::chrono::nanoseconds SimulationClock::now() {
+    if (!virtualTime) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+    }
+
+    std::lock_guard<std::mutex> lock(clockMutex);
+    return std::chrono::nanoseconds(currentTime);
+}
+
+void SimulationClock::addParticipant(Participant& participant) {
+    if (!virtualTime) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(clockMutex);
+    setBusy(participant);
+}
+
+void SimulationClock::removeParticipant(Participant& participant) {
+    if (!virtualTime) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(clockMutex);
+    cancelEvent(participant);
+    if (participant.state == State::BUSY) {
+        busyParticipants--;
+    }
+    participant.state = State::DETACHED;
+    advanceIfIdle();
+}
+
+void SimulationClock::sleepFor(Participant& participant, std::chrono::nanoseconds duration) {
+    if (!virtualTime) {
+        std::this_thread::sleep_for(duration);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(clockMutex);
+    participant.event = events.emplace(currentTime + duration.count(), &participant);
+    participant.hasEvent = true;
+    setIdle(participant, State::SLEEPING);
+    advanceIfIdle();
+
+    // The clock marks the sleeper busy again when its event fires
+    clockAdvanced.wait(lock, [&participant] { return participant.state == State::BUSY; });
+}
+
+void SimulationClock::wake(Participant& participant) {
+    if (!virtualTime) {
+        return;
+    }
+
+    // Only threads waiting on a condition are woken early, a timed sleep always runs to its event
+    std::lock_guard<std::mutex> lock(clockMutex);
+    if (participant.state == State::WAITING) {
+        cancelEvent(participant);
+        setBusy(participant);
+        clockAdvanced.notify_all(); // For a waitUntil caller, condition waiters are notified by the waker
+    }
+}
+
+long long SimulationClock::getTick() {
+    return now().count() / tickLength;
+}
+
+std::chrono::nanoseconds SimulationClock::toDuration(double seconds) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+}
+
+void SimulationClock::setIdle(Participant& participant, State state) {
+    if (participant.state == State::BUSY) {
+        busyParticipants--;
+    }
+    participant.state = state;
+}
+
+void SimulationClock::setBusy(Participant& participant) {
+    if (participant.state != State::BUSY) {
+        busyParticipants++;
+    }
+    participant.state = State::BUSY;
+}
+
+void SimulationClock::cancelEvent(Participant& participant) {
+    if (participant.hasEvent) {
+        events.erase(participant.event);
+        participant.hasEvent = false;
+    }
+}
+
+void SimulationClock::advanceIfIdle() {
+    bool advanced = false;
+
+    while (busyParticipants == 0 && !events.empty()) {
+        currentTime = std::max(currentTime, events.begin()->first);
+
+        // Fire every event due at the new time
+        while (!events.empty() && events.begin()->first <= currentTime) {
+            Participant* participant = events.begin()->second;
+            events.erase(events.begin());
+            participant->hasEvent = false;
+            setBusy(*participant);
+        }
+        advanced = true;
+    }
+
+    if (advanced) {
+        clockAdvanced.notify_all();
+    }
+}
+
+void SimulationClock::beginWait(Participant& participant, long long deadline) {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    cancelEvent(participant);
+    if (deadline >= 0) {
+        participant.event = events.emplace(deadline, &participant);
+        participant.hasEvent = true;
+    }
+    setIdle(participant, State::WAITING);
+    advanceIfIdle();
+}
+
+void SimulationClock::endWait(Participant& participant) {
+    std::lock_guard<std::mutex> lock(clockMutex);
+    cancelEvent(participant);
+    setBusy(participant); // Already busy if a waker or the event got here first
+}
+
+void SimulationClock::awaitBusy(Participant& participant) {
+    std::unique_lock<std::mutex> lock(clockMutex);
+    clockAdvanced.wait(lock, [&participant] { return participant.state == State::BUSY; });
+}
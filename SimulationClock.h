@@ -0,0 +1,105 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <map>
+
+#include "ConfigurationManager.h"
+
+// Clock shared by the Scheduler, the CoreWorkers and the scheduler test loop.
+// In realtime mode it simply wraps the steady clock and real sleeps. In virtual
+// mode it is a discrete-event clock: every emulator thread is a participant,
+// timed sleeps are events in a queue, and once every participant is idle the
+// clock jumps straight to the next event instead of waiting it out.
+class SimulationClock
+{
+public:
+    enum class State { DETACHED, BUSY, WAITING, SLEEPING }; // DETACHED threads are not tracked by the clock
+
+    // One per participating thread, tells the clock whether that thread can still make progress
+    struct Participant {
+        State state = State::DETACHED;
+        bool hasEvent = false;
+        std::multimap<long long, Participant*>::iterator event; // Pending timed wakeup, valid if hasEvent
+    };
+
+    SimulationClock();
+
+    void initialize(ConfigurationManager* configManager);
+    bool isVirtual() const;
+
+    std::chrono::nanoseconds now(); // Simulated time since the clock was initialized
+    long long getTick(); // Simulated CPU ticks since the clock was initialized, one per delay-per-exec period
+
+    void addParticipant(Participant& participant); // Call before starting the participant's thread
+    void removeParticipant(Participant& participant); // Call when the participant's thread exits
+
+    void sleepFor(Participant& participant, std::chrono::nanoseconds duration);
+
+    // Call before notifying a waiting participant so time cannot advance before it picks up the work
+    void wake(Participant& participant);
+
+    // Condition variable waits that count the caller as idle while blocked
+    template <typename Predicate>
+    void wait(Participant& participant, std::unique_lock<std::mutex>& lock, std::condition_variable& cv, Predicate predicate);
+
+    template <typename Predicate>
+    bool waitUntil(Participant& participant, std::unique_lock<std::mutex>& lock, std::condition_variable& cv, std::chrono::nanoseconds deadline, Predicate predicate);
+
+    static std::chrono::nanoseconds toDuration(double seconds);
+    static const long long DEFAULT_TICK_NANOSECONDS = 1000000; // Tick length when delay-per-exec is 0
+
+private:
+    bool virtualTime;
+    std::chrono::steady_clock::time_point startTime;
+    long long tickLength; // Nanoseconds of simulated time per tick
+
+    std::mutex clockMutex;
+    std::condition_variable clockAdvanced; // Wakes sleepers and timed waiters whose event fired or who were woken
+    long long currentTime; // Virtual time in nanoseconds
+    int busyParticipants;
+    std::multimap<long long, Participant*> events; // Pending timed wakeups keyed by virtual time
+
+    // The following are called with clockMutex held
+    void setIdle(Participant& participant, State state);
+    void setBusy(Participant& participant);
+    void cancelEvent(Participant& participant);
+    void advanceIfIdle(); // Jump to the next event while every participant is idle
+    void beginWait(Participant& participant, long long deadline); // deadline < 0 for none
+    void endWait(Participant& participant);
+    void awaitBusy(Participant& participant); // Takes clockMutex itself, blocks until an event or wake() marks the participant busy
+};
+
+template <typename Predicate>
+void SimulationClock::wait(Participant& participant, std::unique_lock<std::mutex>& lock, std::condition_variable& cv, Predicate predicate) {
+    if (!virtualTime) {
+        cv.wait(lock, predicate);
+        return;
+    }
+
+    // Re-registered as waiting on every pass in case a wakeup was consumed by another thread
+    while (!predicate()) {
+        beginWait(participant, -1);
+        cv.wait(lock);
+    }
+    endWait(participant);
+}
+
+template <typename Predicate>
+bool SimulationClock::waitUntil(Participant& participant, std::unique_lock<std::mutex>& lock, std::condition_variable& cv, std::chrono::nanoseconds deadline, Predicate predicate) {
+    if (!virtualTime) {
+        return cv.wait_until(lock, startTime + deadline, predicate);
+    }
+
+    // The event fires without the caller's lock, so a notification on cv could slip past before the caller waits on it.
+    // The caller waits on the clock instead, wakers mark it busy through wake() after updating the predicate's state
+    while (!predicate() && now() < deadline) {
+        beginWait(participant, deadline.count());
+        lock.unlock();
+        awaitBusy(participant);
+        lock.lock();
+    }
+    endWait(participant);
+    return predicate();
+}
@@ -0,0 +1,103 @@
+#include "TLB.h"
+
+#include <algorithm>
+
+TLB::TLB(int numEntries, int associativity, bool asidTagged)
+    : associativity(std::max(1, std::min(associativity, numEntries))), asidTagged(asidTagged) {
+    numSets = std::max(1, numEntries / this->associativity);
+    entries.resize(static_cast<size_t>(numSets) * this->associativity);
+}
+
+bool TLB::lookup(int asid, int page) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    Entry* entry = findEntry(asid, page);
+    if (!entry) {
+        misses++;
+        return false;
+    }
+
+    entry->lastUsed = ++useCounter;
+    hits++;
+    return true;
+}
+
+void TLB::insert(int asid, int page) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    if (findEntry(asid, page)) {
+        return;
+    }
+
+    // Fill an invalid way if there is one, otherwise replace the least recently used
+    Entry* set = &entries[setStart(asid, page)];
+    Entry* victim = set;
+    for (int way = 0; way < associativity; way++) {
+        if (set[way].asid == -1) {
+            victim = &set[way];
+            break;
+        }
+        if (set[way].lastUsed < victim->lastUsed) {
+            victim = &set[way];
+        }
+    }
+
+    victim->asid = asid;
+    victim->page = page;
+    victim->dirty = false;
+    victim->lastUsed = ++useCounter;
+}
+
+bool TLB::markDirty(int asid, int page) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    Entry* entry = findEntry(asid, page);
+    if (entry && entry->dirty) {
+        return false;
+    }
+    if (entry) {
+        entry->dirty = true;
+    }
+    return true;
+}
+
+void TLB::invalidate(int asid, int page) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    Entry* entry = findEntry(asid, page);
+    if (entry) {
+        entry->asid = -1;
+    }
+}
+
+void TLB::switchTo(int asid) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    if (asidTagged || asid == currentASID) {
+        return; // Tagged entries stay valid, and resuming the same process needs no flush
+    }
+
+    if (currentASID != -1) {
+        for (Entry& entry : entries) {
+            entry.asid = -1;
+        }
+        flushes++;
+    }
+    currentASID = asid;
+}
+
+std::vector<long long> TLB::getStats() {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    return { hits, misses, flushes };
+}
+
+TLB::Entry* TLB::findEntry(int asid, int page) {
+    Entry* set = &entries[setStart(asid, page)];
+    for (int way = 0; way < associativity; way++) {
+        if (set[way].asid == asid && set[way].page == page) {
+            return &set[way];
+        }
+    }
+    return nullptr;
+}
+
+size_t TLB::setStart(int asid, int page) const {
+    // Mix in the ASID so page 0 of every process does not land in the same set
+    uint32_t hash = static_cast<uint32_t>(page) + static_cast<uint32_t>(asid) * 0x9E3779B1u;
+    return static_cast<size_t>(hash % static_cast<uint32_t>(numSets)) * associativity;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+// Set-associative translation lookaside buffer, one per core. Entries map a
+// (process, virtual page) pair to "resident" and are replaced LRU within a set.
+// With ASID tagging entries of different processes coexist and survive context
+// switches; without it the core flushes the whole buffer on every switch. The
+// MemoryManager shoots entries down when it evicts their page.
+class TLB
+{
+public:
+    TLB(int numEntries, int associativity, bool asidTagged);
+
+    bool lookup(int asid, int page); // Counts a hit or a miss
+    void insert(int asid, int page); // Cache a translation after a miss
+    bool markDirty(int asid, int page); // Record a write, true if the page table must be told (first write or no entry)
+    void invalidate(int asid, int page); // Shootdown, the page is no longer resident
+    void switchTo(int asid); // Context switch, flushes unless entries are ASID-tagged
+
+    std::vector<long long> getStats(); // Hits, misses and flushes
+
+private:
+    struct Entry {
+        int asid = -1; // -1 while the entry is invalid
+        int page = -1;
+        bool dirty = false; // The page table already knows the page was written
+        uint32_t lastUsed = 0; // Use stamp for LRU within the set
+    };
+
+    int numSets;
+    int associativity;
+    bool asidTagged;
+    std::vector<Entry> entries; // Set s occupies [s * associativity, (s + 1) * associativity)
+    uint32_t useCounter = 0;
+    int currentASID = -1; // Process whose translations are loaded, only tracked without ASID tagging
+
+    long long hits = 0;
+    long long misses = 0;
+    long long flushes = 0;
+
+    std::mutex tlbMutex; // The owning core looks up and inserts, the memory thread shoots down
+
+    Entry* findEntry(int asid, int page); // Called with tlbMutex held
+    size_t setStart(int asid, int page) const; // Index of the first way of the pair's set
+};
@@ -0,0 +1,129 @@
+// Standalone checks for BuddyAllocator splitting and merging: blocks are split down to the rounded-up
+// request, freed blocks merge only with their free buddy, and memory that is not a power of two is
+// never merged past its end. Built on its own, outside the emulator project, e.g.
+//   cl /EHsc /std:c++14 /I.. BuddyAllocatorTest.cpp ..\BuddyAllocator.cpp ..\ReplacementPolicy.cpp ..\ConfigurationManager.cpp
+//      ..\Process.cpp ..\InstructionGenerator.cpp
+// Run it from a scratch directory, it writes its own config.txt.
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "BuddyAllocator.h"
+#include "ConfigurationManager.h"
+
+static void writeConfig(int memory) {
+    std::ofstream config("config.txt");
+    config << "num-cpu 1\nscheduler \"fcfs\"\nquantum-cycles 0\npreemptive 0\nbatch-process-freq 1\n"
+        << "min-ins 1\nmax-ins 1\ndelay-per-exec 0\nmax-overall-mem " << memory << "\nmin-mem-per-proc 1\nmax-mem-per-proc " << memory << "\n"
+        << "min-page-per-proc 1\nmax-page-per-proc 1\nmemory-manager \"buddy\"\npage-replacement \"fifo\"\n";
+}
+
+// The free blocks as displayMemory prints them, one "start:size" per block, smallest order first
+static std::string freeBlocks(BuddyAllocator& allocator) {
+    std::ostringstream captured;
+    std::streambuf* original = std::cout.rdbuf(captured.rdbuf());
+    allocator.displayMemory();
+    std::cout.rdbuf(original);
+
+    std::istringstream lines(captured.str());
+    std::string line;
+    std::string blocks;
+    std::string start;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 7, "Start: ") == 0) {
+            start = line.substr(7);
+        }
+        else if (line.compare(0, 6, "Size: ") == 0) {
+            blocks += (blocks.empty() ? "" : " ") + start + ":" + line.substr(6);
+        }
+    }
+    return blocks;
+}
+
+class Fixture {
+public:
+    explicit Fixture(int memory) {
+        writeConfig(memory);
+        assert(configManager.initialize());
+        allocator.initialize(&configManager);
+    }
+
+    bool allocate(int pid, int size) {
+        processes.push_back(std::unique_ptr<Process>(new Process("p" + std::to_string(pid), pid, 1, static_cast<float>(size), 1)));
+        return allocator.allocate(*processes.back());
+    }
+
+    ConfigurationManager configManager;
+    BuddyAllocator allocator;
+    std::vector<std::unique_ptr<Process>> processes;
+};
+
+static void splitsDownToTheRequest() {
+    Fixture memory(64);
+    assert(freeBlocks(memory.allocator) == "0:64");
+
+    // 64 splits into 32 + 16 + 8 + 8, the request keeps the lowest block
+    assert(memory.allocate(1, 8));
+    assert(freeBlocks(memory.allocator) == "8:8 16:16 32:32");
+    assert(memory.allocator.getUsedMemory() == 8);
+
+    // Requests are rounded up to a power of two, 12 takes the free 16
+    assert(memory.allocate(2, 12));
+    assert(freeBlocks(memory.allocator) == "8:8 32:32");
+    assert(memory.allocator.getUsedMemory() == 24);
+
+    assert(!memory.allocate(3, 33)); // Rounds to 64, no block that large is free
+}
+
+static void mergesOnlyWithFreeBuddies() {
+    Fixture memory(64);
+    for (int pid = 1; pid <= 4; pid++) {
+        assert(memory.allocate(pid, 16)); // At 0, 16, 32 and 48
+    }
+    assert(freeBlocks(memory.allocator).empty());
+    assert(!memory.allocate(5, 16));
+
+    // 0 and 32 are not buddies, nothing merges
+    memory.allocator.deallocate(1);
+    memory.allocator.deallocate(3);
+    assert(freeBlocks(memory.allocator) == "0:16 32:16");
+    assert(!memory.allocate(6, 32));
+
+    // Freeing 16 merges it with 0 into a 32
+    memory.allocator.deallocate(2);
+    assert(freeBlocks(memory.allocator) == "32:16 0:32");
+
+    // Freeing 48 merges it with 32, and that 32 with 0, back to the whole of memory
+    memory.allocator.deallocate(4);
+    assert(freeBlocks(memory.allocator) == "0:64");
+    assert(memory.allocator.getUsedMemory() == 0);
+
+    memory.allocator.deallocate(4); // Unknown pids are ignored
+    assert(freeBlocks(memory.allocator) == "0:64");
+}
+
+static void unevenMemoryNeverMergesPastTheEnd() {
+    Fixture memory(96); // Roots of 64 and 32
+    assert(freeBlocks(memory.allocator) == "64:32 0:64");
+
+    assert(memory.allocate(1, 32)); // Fits the 32 root without splitting the 64
+    assert(freeBlocks(memory.allocator) == "0:64");
+    assert(memory.allocate(2, 64));
+    assert(!memory.allocate(3, 1));
+
+    memory.allocator.deallocate(1);
+    memory.allocator.deallocate(2);
+    assert(freeBlocks(memory.allocator) == "64:32 0:64"); // 64 and 96 are not buddies of a 128 block
+    assert(!memory.allocate(4, 96));
+}
+
+int main() {
+    splitsDownToTheRequest();
+    mergesOnlyWithFreeBuddies();
+    unevenMemoryNeverMergesPastTheEnd();
+    std::cout << "BuddyAllocatorTest passed" << std::endl;
+    return 0;
+}
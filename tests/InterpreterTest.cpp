@@ -0,0 +1,142 @@
+// Standalone checks for the process interpreter: generated programs execute exactly their requested
+// instruction count with every FOR iteration counted, and SLEEP keeps the process WAITING for its ticks.
+// Built on its own, outside the emulator project, e.g.
+//   cl /EHsc /std:c++14 /I.. InterpreterTest.cpp ..\Process.cpp ..\InstructionGenerator.cpp
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "InstructionGenerator.h"
+#include "Process.h"
+
+// Runs the chunks the way Process::execute does and counts executed instructions, SLEEP ticks not included
+static int countExecuted(InstructionGenerator& generator, int& loops, int& sleeps) {
+    int executed = 0;
+    std::vector<Instruction> chunk;
+    while (generator.nextChunk(chunk)) {
+        assert(!chunk.empty());
+
+        struct Frame { size_t bodyStart; int remaining; };
+        std::vector<Frame> stack;
+        for (size_t pc = 0; pc < chunk.size();) {
+            const Instruction& instruction = chunk[pc++];
+            executed++;
+            if (instruction.opcode == Opcode::FOR) {
+                assert(instruction.a >= 2);
+                stack.push_back({ pc, instruction.a });
+                assert(stack.size() <= static_cast<size_t>(InstructionGenerator::MAX_LOOP_DEPTH));
+                loops++;
+            }
+            else if (instruction.opcode == Opcode::END_FOR) {
+                assert(!stack.empty()); // Loops never straddle two chunks
+                assert(instruction.a == pc - 1 - stack.back().bodyStart);
+                if (--stack.back().remaining > 0) {
+                    pc = stack.back().bodyStart;
+                }
+                else {
+                    stack.pop_back();
+                }
+            }
+            else if (instruction.opcode == Opcode::SLEEP) {
+                assert(instruction.a >= 1 && instruction.a <= InstructionGenerator::MAX_SLEEP_TICKS);
+                sleeps++;
+            }
+        }
+        assert(stack.empty());
+    }
+    assert(generator.isExhausted());
+    return executed;
+}
+
+static void generatedProgramsHitTheirTotal() {
+    int loops = 0;
+    int sleeps = 0;
+    for (int total : { 1, 4, 5, 17, 64, 100, 1000, 5000 }) {
+        for (uint32_t seed = 1; seed <= 50; seed++) {
+            InstructionGenerator generator(total, seed);
+            assert(countExecuted(generator, loops, sleeps) == total);
+        }
+    }
+    assert(loops > 0 && sleeps > 0); // Both were exercised
+
+    // The same seed yields the same program
+    InstructionGenerator first(300, 7);
+    InstructionGenerator second(300, 7);
+    std::vector<Instruction> a;
+    std::vector<Instruction> b;
+    while (first.nextChunk(a)) {
+        assert(second.nextChunk(b) && a.size() == b.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            assert(a[i].opcode == b[i].opcode && a[i].a == b[i].a && a[i].b == b[i].b && a[i].dest == b[i].dest);
+        }
+    }
+    assert(!second.nextChunk(b));
+}
+
+static void processCountsInstructionsAndSleeps() {
+    for (int id = 1; id <= 50; id++) {
+        const int total = 500;
+        Process process("p", id, total, 64, 16);
+        process.setState(Process::State::RUNNING);
+
+        int ticks = 0;
+        int sleepTicks = 0;
+        while (!process.isFinished()) {
+            int before = process.getCurrentInstruction();
+            process.execute();
+            ticks++;
+
+            if (process.getState() == Process::State::WAITING) {
+                // A sleep tick or the SLEEP itself, the program counter only moves for the latter
+                assert(process.getCurrentInstruction() - before <= 1);
+
+                // Dispatching again after a requeue does not wake it early
+                process.markDispatched(std::chrono::nanoseconds(ticks));
+                assert(process.getState() == Process::State::WAITING);
+            }
+            if (process.getCurrentInstruction() == before && !process.isFinished()) {
+                sleepTicks++;
+            }
+            assert(ticks < total * (InstructionGenerator::MAX_SLEEP_TICKS + 2)); // Never stuck
+        }
+
+        assert(process.getCurrentInstruction() == total);
+        assert(ticks == total + sleepTicks + 1); // The last call finds the program exhausted
+    }
+}
+
+static void sleepWaitsExactlyItsTicks() {
+    // Find a process whose program starts with a SLEEP outside a loop
+    for (int id = 1; id < 10000; id++) {
+        InstructionGenerator generator(50, static_cast<uint32_t>(id));
+        std::vector<Instruction> chunk;
+        generator.nextChunk(chunk);
+        if (chunk[0].opcode != Opcode::SLEEP) {
+            continue;
+        }
+
+        Process process("sleeper", id, 50, 64, 16);
+        process.setState(Process::State::RUNNING);
+        process.execute();
+        assert(process.getCurrentInstruction() == 1);
+        for (int tick = 1; tick < chunk[0].a; tick++) {
+            assert(process.getState() == Process::State::WAITING);
+            process.execute();
+        }
+        assert(process.getState() == Process::State::WAITING);
+        process.execute(); // Last tick of the sleep
+        assert(process.getState() == Process::State::RUNNING);
+        assert(process.getCurrentInstruction() == 1);
+        return;
+    }
+    assert(false);
+}
+
+int main() {
+    generatedProgramsHitTheirTotal();
+    processCountsInstructionsAndSleeps();
+    sleepWaitsExactlyItsTicks();
+    std::cout << "InterpreterTest passed" << std::endl;
+    return 0;
+}
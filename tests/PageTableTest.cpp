@@ -0,0 +1,160 @@
+// Standalone checks for the page table layouts: every layout must read back what was written, visit
+// the same pages, and forget a process once it is removed. Then the layout specifics: two-level tables
+// are allocated on first write only, and the inverted table is bounded by physical frames.
+// Built on its own, outside the emulator project, e.g.
+//   cl /EHsc /std:c++14 /I.. PageTableTest.cpp ..\PageTable.cpp
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "PageTable.h"
+
+static const int NUM_FRAMES = 8;
+
+static PageTableEntry resident(int frame) {
+    PageTableEntry entry;
+    entry.set(PageTableEntry::PRESENT);
+    entry.setFrame(frame);
+    return entry;
+}
+
+static PageTableEntry swapped(int slot) {
+    PageTableEntry entry;
+    entry.set(PageTableEntry::IN_SWAP);
+    entry.setSwapSlot(slot);
+    return entry;
+}
+
+static std::map<int, uint64_t> collect(PageTable& table, int pid, bool residentOnly) {
+    std::map<int, uint64_t> pages;
+    auto record = [&](int page, PageTableEntry& entry) {
+        assert(pages.count(page) == 0); // Each page visited once
+        pages[page] = entry.bits;
+    };
+    if (residentOnly) {
+        table.forEachResident(pid, record);
+    }
+    else {
+        table.forEachEntry(pid, record);
+    }
+    return pages;
+}
+
+static void behavesLikeAPageTable(const std::string& layout) {
+    auto table = PageTable::create(layout, NUM_FRAMES);
+    assert(table && table->getName() == layout);
+
+    table->addProcess(1, 1000);
+    table->addProcess(2, 10);
+    assert(table->contains(1) && table->contains(2) && !table->contains(3));
+    assert(table->getNumPages(1) == 1000 && table->getNumPages(3) == 0);
+    auto processIDs = table->getProcessIDs();
+    std::sort(processIDs.begin(), processIDs.end());
+    assert(processIDs == std::vector<int>({ 1, 2 }));
+
+    // Unwritten and out of range pages read back empty, writes out of range are dropped
+    assert(table->get(1, 999).bits == 0);
+    assert(table->get(1, 1000).bits == 0 && table->get(3, 0).bits == 0);
+    table->set(2, 10, resident(0));
+    table->set(3, 0, resident(0));
+    assert(collect(*table, 2, false).empty());
+
+    // Pages in different second-level ranges, one of them evicted to swap
+    PageTableEntry dirty = resident(5);
+    dirty.set(PageTableEntry::DIRTY);
+    table->set(1, 0, resident(4));
+    table->set(1, 999, dirty);
+    table->set(1, 600, swapped(42));
+    assert(table->get(1, 0).getFrame() == 4);
+    assert(table->get(1, 999).has(PageTableEntry::DIRTY) && table->get(1, 999).getFrame() == 5);
+    assert(table->get(1, 600).getSwapSlot() == 42 && !table->get(1, 600).has(PageTableEntry::PRESENT));
+
+    auto residentPages = collect(*table, 1, true);
+    assert(residentPages.size() == 2 && residentPages.count(0) && residentPages.count(999));
+    auto entries = collect(*table, 1, false);
+    assert(entries.size() == 3 && entries.count(600));
+
+    // Flags other than PRESENT may be changed while visiting
+    table->forEachResident(1, [](int, PageTableEntry& entry) { entry.set(PageTableEntry::REFERENCED); });
+    assert(table->get(1, 0).has(PageTableEntry::REFERENCED) && table->get(1, 999).has(PageTableEntry::REFERENCED));
+    table->forEachEntry(1, [](int, PageTableEntry& entry) { entry.clear(PageTableEntry::REFERENCED); });
+    assert(!table->get(1, 0).has(PageTableEntry::REFERENCED));
+
+    // Eviction keeps only the swap slot, clearing the entry forgets the page
+    table->set(1, 999, swapped(7));
+    assert(collect(*table, 1, true).size() == 1);
+    table->set(1, 600, PageTableEntry());
+    entries = collect(*table, 1, false);
+    assert(entries.size() == 2 && entries.count(0) && entries.count(999));
+
+    // The allocator clears the old owner before it hands the frame to another process
+    table->set(1, 0, PageTableEntry());
+    table->set(2, 3, resident(4));
+    assert(table->get(2, 3).getFrame() == 4);
+    assert(!table->get(1, 0).has(PageTableEntry::PRESENT));
+
+    table->removeProcess(1);
+    assert(!table->contains(1) && table->get(1, 999).bits == 0 && collect(*table, 1, false).empty());
+    assert(table->get(2, 3).getFrame() == 4); // Other processes are untouched
+    table->removeProcess(2);
+    assert(table->getProcessIDs().empty());
+}
+
+static void flatSizesByAddressSpace() {
+    auto table = PageTable::create("flat", NUM_FRAMES);
+    table->addProcess(1, 1000);
+    table->addProcess(2, 10);
+    assert(table->getMemoryBytes() == 1010 * sizeof(PageTableEntry));
+}
+
+static void twoLevelAllocatesTablesOnWrite() {
+    auto table = PageTable::create("two-level", NUM_FRAMES);
+    table->addProcess(1, 3 * TwoLevelPageTable::SECOND_LEVEL_SIZE);
+    size_t directoryOnly = table->getMemoryBytes();
+    const size_t tableBytes = TwoLevelPageTable::SECOND_LEVEL_SIZE * sizeof(PageTableEntry);
+
+    table->set(1, 0, PageTableEntry()); // Writing an empty entry needs no table
+    assert(table->getMemoryBytes() == directoryOnly);
+
+    table->set(1, 1, resident(0));
+    table->set(1, 2, resident(1)); // Same range as page 1
+    assert(table->getMemoryBytes() == directoryOnly + tableBytes);
+    table->set(1, 3 * TwoLevelPageTable::SECOND_LEVEL_SIZE - 1, resident(2));
+    assert(table->getMemoryBytes() == directoryOnly + 2 * tableBytes);
+
+    table->removeProcess(1);
+    assert(table->getMemoryBytes() == 0);
+}
+
+static void invertedIsBoundedByFrames() {
+    auto table = PageTable::create("inverted", NUM_FRAMES);
+    size_t empty = table->getMemoryBytes();
+    table->addProcess(1, 1000000); // Address space size costs nothing
+    size_t perProcess = table->getMemoryBytes() - empty;
+
+    for (int page = 0; page < NUM_FRAMES; page++) {
+        table->set(1, page * 1000, resident(page));
+    }
+    assert(table->getMemoryBytes() == empty + perProcess); // Resident pages live in the frame array
+    assert(collect(*table, 1, true).size() == NUM_FRAMES);
+
+    // Moving a page to another frame leaves a single resident copy
+    table->set(1, 0, PageTableEntry());
+    table->set(1, 1000, resident(0));
+    auto residentPages = collect(*table, 1, true);
+    assert(residentPages.size() == NUM_FRAMES - 1 && table->get(1, 1000).getFrame() == 0);
+}
+
+int main() {
+    assert(!PageTable::create("hashed", NUM_FRAMES));
+    for (const char* layout : { "flat", "two-level", "inverted" }) {
+        behavesLikeAPageTable(layout);
+    }
+    flatSizesByAddressSpace();
+    twoLevelAllocatesTablesOnWrite();
+    invertedIsBoundedByFrames();
+    std::cout << "PageTableTest passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Standalone checks for ProcessTable slot reuse and ProcessRegistry retirement.
+// Built on its own, outside the emulator project, e.g.
+//   cl /EHsc /std:c++14 /I.. ProcessTableTest.cpp ..\ProcessTable.cpp ..\ProcessRegistry.cpp ..\Process.cpp ..\InstructionGenerator.cpp
+#include <cassert>
+#include <iostream>
+
+#include "ProcessTable.h"
+#include "ProcessRegistry.h"
+
+static void staleHandleFailsAfterReuse() {
+    ProcessTable table;
+    ProcessHandle first = table.create("p1", 1, 10, 64, 16);
+    assert(table.get(first) && table.get(first)->getID() == 1);
+
+    table.release(first);
+    assert(!table.isValid(first));
+    assert(!table.get(first));
+
+    // The released slot is the first one handed out again
+    ProcessHandle second = table.create("p2", 2, 10, 64, 16);
+    assert(second.index == first.index);
+    assert(second.generation != first.generation);
+
+    assert(!table.get(first)); // Must not resolve to p2
+    assert(table.get(second) && table.get(second)->getName() == "p2");
+    assert(table.size() == 1);
+
+    // Releasing through the stale handle leaves the new occupant alone
+    table.release(first);
+    assert(table.get(second));
+}
+
+static void heldProcessDefersReuse() {
+    ProcessTable table;
+    ProcessHandle first = table.create("p1", 1, 10, 64, 16);
+    auto reader = table.get(first); // Like a status snapshot taken just before the process finished
+    table.release(first);
+    assert(!table.get(first));
+
+    // The slot is still being read, so the next process gets a fresh one
+    ProcessHandle second = table.create("p2", 2, 10, 64, 16);
+    assert(second.index != first.index);
+    assert(reader->getName() == "p1" && reader->getID() == 1);
+
+    // Once the reader lets go the released slot is reused
+    reader.reset();
+    ProcessHandle third = table.create("p3", 3, 10, 64, 16);
+    assert(third.index == first.index);
+    assert(table.get(third)->getName() == "p3");
+}
+
+static void retiredProcessKeepsOnlyItsRecord() {
+    ProcessTable table;
+    ProcessRegistry registry;
+    auto finished = table.get(table.create("done", 1, 10, 64, 16));
+    auto running = table.get(table.create("busy", 2, 10, 64, 16));
+    registry.add(finished);
+    registry.add(running);
+
+    registry.retire(finished);
+    table.release(finished->getHandle());
+
+    assert(!registry.findByName("done"));
+    assert(!registry.findByID(1));
+    assert(registry.findByID(2) == running);
+    assert(registry.contains("done")); // Name stays taken
+    assert(registry.size() == 1);
+    assert(registry.getAll().size() == 1 && registry.getAll()[0] == running);
+    assert(registry.getFinished().size() == 1 && registry.getFinished()[0].name == "done");
+
+    // A new process in the reused slot cannot take the retired name
+    auto reused = table.get(table.create("done", 3, 10, 64, 16));
+    assert(!registry.add(reused));
+}
+
+int main() {
+    staleHandleFailsAfterReuse();
+    heldProcessDefersReuse();
+    retiredProcessKeepsOnlyItsRecord();
+    std::cout << "ProcessTableTest passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Standalone checks for the lock-free ReadyQueue under producer/consumer contention, with a timing
+// against the mutex-guarded deque it replaced. Built on its own, outside the emulator project, e.g.
+//   cl /EHsc /O2 /std:c++14 /I.. ReadyQueueTest.cpp ..\ReadyQueue.cpp ..\Process.cpp ..\InstructionGenerator.cpp
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ReadyQueue.h"
+
+static const int PRODUCERS = 4;
+static const int CONSUMERS = 4;
+static const int PER_PRODUCER = 50000;
+
+// The queue only moves pointers, so every producer pushes the same few processes and the
+// consumers count what arrives by PID
+static std::vector<std::shared_ptr<Process>> makeProcesses() {
+    std::vector<std::shared_ptr<Process>> processes;
+    for (int i = 0; i < PRODUCERS; i++) {
+        processes.push_back(std::make_shared<Process>("p" + std::to_string(i), i, 1, 0, 1));
+    }
+    return processes;
+}
+
+static void boundsAreRespected() {
+    ReadyQueue queue(3); // Rounded up to 4
+    assert(queue.capacity() == 4);
+    assert(queue.empty());
+
+    auto process = std::make_shared<Process>("p", 1, 1, 0, 1);
+    for (int i = 0; i < 4; i++) {
+        assert(queue.push(process));
+    }
+    assert(!queue.push(process)); // Full
+    assert(queue.size() == 4);
+
+    std::shared_ptr<Process> popped;
+    for (int i = 0; i < 4; i++) {
+        assert(queue.pop(popped) && popped == process);
+    }
+    assert(!queue.pop(popped)); // Empty
+}
+
+// Runs PRODUCERS x CONSUMERS threads through push and pop, returns the elapsed milliseconds
+template <typename Push, typename Pop>
+static long long runContention(Push push, Pop pop) {
+    auto processes = makeProcesses();
+    std::atomic<int> received[PRODUCERS];
+    for (auto& count : received) {
+        count = 0;
+    }
+    std::atomic<int> remaining(PRODUCERS * PER_PRODUCER);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                while (!push(processes[p])) {
+                    std::this_thread::yield();
+                }
+            }
+            });
+    }
+    for (int c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&] {
+            std::shared_ptr<Process> process;
+            while (remaining > 0) {
+                if (pop(process)) {
+                    received[process->getID()]++;
+                    remaining--;
+                }
+            }
+            });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Nothing lost and nothing delivered twice
+    for (auto& count : received) {
+        assert(count == PER_PRODUCER);
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+int main() {
+    boundsAreRespected();
+
+    ReadyQueue queue(1024); // Small enough that producers also hit the full case
+    long long lockFree = runContention(
+        [&](const std::shared_ptr<Process>& process) { return queue.push(process); },
+        [&](std::shared_ptr<Process>& process) { return queue.pop(process); });
+    assert(queue.empty());
+
+    std::mutex dequeMutex;
+    std::deque<std::shared_ptr<Process>> deque;
+    long long locked = runContention(
+        [&](const std::shared_ptr<Process>& process) {
+            std::lock_guard<std::mutex> lock(dequeMutex);
+            if (deque.size() >= 1024) {
+                return false;
+            }
+            deque.push_back(process);
+            return true;
+        },
+        [&](std::shared_ptr<Process>& process) {
+            std::lock_guard<std::mutex> lock(dequeMutex);
+            if (deque.empty()) {
+                return false;
+            }
+            process = deque.front();
+            deque.pop_front();
+            return true;
+        });
+
+    std::cout << PRODUCERS << " producers, " << CONSUMERS << " consumers, " << PRODUCERS * PER_PRODUCER << " processes: "
+        << "ReadyQueue " << lockFree << " ms, mutex deque " << locked << " ms" << std::endl;
+    std::cout << "ReadyQueueTest passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Standalone checks for the per-core local run queues: the bound that sends the Scheduler's extra processes
+// back to its own overflow, FIFO order, and an idle core stealing the processes queued behind a busy one.
+// Built on its own, outside the emulator project, e.g.
+//   cl /EHsc /std:c++14 /I.. RunQueueTest.cpp ..\CoreWorker.cpp ..\CoreBitmap.cpp ..\TLB.cpp ..\ReadyQueue.cpp ..\SimulationClock.cpp
+//      ..\ConfigurationManager.cpp ..\Process.cpp ..\InstructionGenerator.cpp
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "CoreBitmap.h"
+#include "CoreWorker.h"
+#include "SimulationClock.h"
+
+template <typename Condition>
+static bool waitFor(Condition condition) {
+    for (int i = 0; i < 1000 && !condition(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+static std::shared_ptr<Process> makeReady(int id, int instructions) {
+    auto process = std::make_shared<Process>("p" + std::to_string(id), id, instructions, 64, 16);
+    process->setState(Process::State::READY);
+    return process;
+}
+
+static void queueIsBoundedAndFIFO() {
+    SimulationClock clock;
+    CoreBitmap idleCores(1);
+    CoreWorker core(1, &clock, &idleCores, std::unique_ptr<TLB>(new TLB(16, 4, true)), 0.001f);
+
+    // Not started, so nothing is pulled off the queue
+    for (int i = 0; i < static_cast<int>(CoreWorker::LOCAL_QUEUE_CAPACITY); i++) {
+        assert(core.enqueueProcess(makeReady(i, 10)));
+    }
+    assert(!core.enqueueProcess(makeReady(99, 10))); // Full, the Scheduler keeps it in its overflow
+    assert(core.getLoad() == static_cast<int>(CoreWorker::LOCAL_QUEUE_CAPACITY));
+
+    // Thieves take the oldest first, so stolen processes keep their arrival order
+    std::shared_ptr<Process> stolen;
+    for (int i = 0; i < static_cast<int>(CoreWorker::LOCAL_QUEUE_CAPACITY); i++) {
+        assert(core.stealProcess(stolen) && stolen->getID() == i);
+    }
+    assert(!core.stealProcess(stolen));
+    assert(core.getLoad() == 0);
+}
+
+static void idleCoreStealsFromBusyPeer() {
+    SimulationClock clock;
+    CoreBitmap idleCores(2);
+    CoreWorker busy(1, &clock, &idleCores, std::unique_ptr<TLB>(new TLB(16, 4, true)), 0.001f);
+    CoreWorker thief(2, &clock, &idleCores, std::unique_ptr<TLB>(new TLB(16, 4, true)), 0.001f);
+    busy.setPeers({ &thief });
+    thief.setPeers({ &busy });
+
+    // Record which core completed each process
+    std::mutex finishedMutex;
+    std::map<int, int> finishedOn;
+    auto recordOn = [&](int coreID) {
+        return [&, coreID](std::shared_ptr<Process> process) {
+            std::lock_guard<std::mutex> lock(finishedMutex);
+            if (process->isFinished()) {
+                finishedOn[process->getID()] = coreID;
+            }
+        };
+    };
+    busy.setProcessCompletionCallback(recordOn(1));
+    thief.setProcessCompletionCallback(recordOn(2));
+    busy.start();
+    thief.start();
+
+    // About a second of work on core 1 with four short processes queued behind it
+    busy.setProcess(makeReady(1, 1000));
+    for (int id = 2; id <= 5; id++) {
+        assert(busy.enqueueProcess(makeReady(id, 20)));
+    }
+
+    // Core 2 runs one short process, finds its own queue empty and drains core 1's
+    thief.setProcess(makeReady(6, 20));
+    assert(waitFor([&] { std::lock_guard<std::mutex> lock(finishedMutex); return finishedOn.size() == 6; }));
+
+    assert(finishedOn[1] == 1);
+    for (int id = 2; id <= 6; id++) {
+        assert(finishedOn[id] == 2);
+    }
+    assert(busy.getLoad() == 0 && thief.getLoad() == 0);
+
+    busy.stop();
+    thief.stop();
+}
+
+int main() {
+    queueIsBoundedAndFIFO();
+    idleCoreStealsFromBusyPeer();
+    std::cout << "RunQueueTest passed" << std::endl;
+    return 0;
+}
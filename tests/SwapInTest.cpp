@@ -0,0 +1,99 @@
+// Standalone check that flat-allocator processes evicted while they wait are swapped back in and run
+// to completion: one evicted from a core's local run queue while it is being dispatched, one evicted
+// from the Scheduler's ready queue. Built on its own, outside the emulator project, with the emulator
+// sources except main.cpp, the consoles and the ResourceManager. Run it from a scratch directory, it
+// writes its own config.txt.
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "ConfigurationManager.h"
+#include "MemoryManager.h"
+#include "ProcessRegistry.h"
+#include "ProcessTable.h"
+#include "Scheduler.h"
+#include "SimulationClock.h"
+
+template <typename Condition>
+static bool waitFor(Condition condition) {
+    for (int i = 0; i < 1000 && !condition(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+static void writeConfig() {
+    // One core, FCFS: the long process runs while two more sit in the core's run queue and the rest in the ready queue.
+    // Memory holds four processes, FIFO evicts in allocation order and the reclaimer stays off.
+    std::ofstream config("config.txt");
+    config << "num-cpu 1\nscheduler \"fcfs\"\nquantum-cycles 0\npreemptive 0\nbatch-process-freq 1\n"
+        << "min-ins 1\nmax-ins 1\ndelay-per-exec 0.001\nmax-overall-mem 128\nmin-mem-per-proc 32\nmax-mem-per-proc 32\n"
+        << "min-page-per-proc 1\nmax-page-per-proc 1\nmemory-manager \"flat\"\npage-replacement \"fifo\"\n"
+        << "reclaim-low-watermark 0\nreclaim-high-watermark 0\n";
+}
+
+int main() {
+    writeConfig();
+    ConfigurationManager configManager;
+    assert(configManager.initialize());
+
+    SimulationClock clock;
+    clock.initialize(&configManager);
+    ProcessTable processTable;
+    ProcessRegistry registry;
+    MemoryManager memoryManager;
+    Scheduler scheduler;
+    assert(scheduler.initialize(&configManager, &clock, &registry));
+    assert(memoryManager.initialize(&configManager, &scheduler, &clock));
+    scheduler.setFinishHandler([&](std::shared_ptr<Process> process) {
+        memoryManager.deallocate(process->getID());
+        registry.retire(process);
+        processTable.release(process->getHandle());
+        });
+
+    int nextID = 1;
+    auto create = [&](const char* name, int instructions) {
+        auto process = processTable.get(processTable.create(name, nextID++, instructions, 32, 1));
+        registry.add(process);
+        return process;
+    };
+    auto running = create("running", 1500);
+    auto dispatching = create("dispatching", 20);
+    auto resident = create("resident", 20);
+    auto queued = create("queued", 20);
+
+    // Allocation order is eviction order, the running process is protected
+    assert(memoryManager.allocate(*running));
+    assert(memoryManager.allocate(*dispatching));
+    assert(memoryManager.allocate(*queued));
+    assert(memoryManager.allocate(*resident));
+
+    scheduler.addProcess(running);
+    scheduler.addProcess(dispatching);
+    scheduler.addProcess(resident);
+    scheduler.addProcess(queued);
+
+    CoreWorker* core = scheduler.getCores()[0].get();
+    assert(waitFor([&] { return running->getState() == Process::State::RUNNING && core->getLoad() == 3; }));
+    assert(queued->getState() == Process::State::READY); // Left in the ready queue, the core is full
+
+    // Each new allocation evicts the oldest waiting process
+    auto filler1 = create("filler1", 20);
+    auto filler2 = create("filler2", 20);
+    assert(memoryManager.allocate(*filler1));
+    assert(dispatching->getState() == Process::State::SWAPPED);
+    assert(memoryManager.allocate(*filler2));
+    assert(queued->getState() == Process::State::SWAPPED);
+    assert(running->getState() == Process::State::RUNNING);
+
+    // Both are brought back once memory frees up, by the core that dispatches them or by a prefetch.
+    // Bringing one back may evict the other waiting process again, so there can be more than two swap-ins
+    assert(waitFor([&] { return registry.getFinished().size() == 4; }));
+    assert(memoryManager.getSwapInStats()[0] >= 2);
+
+    memoryManager.stop();
+    std::cout << "SwapInTest passed" << std::endl;
+    return 0;
+}